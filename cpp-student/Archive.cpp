@@ -0,0 +1,478 @@
+// Archive.cpp - Compressed block archive for historical rosters
+//
+// File layout:
+//   header : "SARC", version (1 byte), block size (2), student count (4), block count (4)
+//   blocks : block header (26 bytes) followed by the encoded payload
+//
+// Block header: payload bytes (4), student count (2), min ID (8), max ID (8),
+// min average in tenths (2, rounded down), max average in tenths (2, rounded up).
+//
+// Block payload:
+//   name dictionary : count, then (length, chars) for each distinct name
+//   per student     : ID delta from previous ID (varint, first one is absolute),
+//                     name dictionary index (varint), age (1 byte),
+//                     gender and course count (1 byte), then one byte per score
+//                     holding score * 2 (0-200). Scores that are not whole or
+//                     half points use the escape byte 255 and 8 raw bytes.
+#include "Archive.h"
+#include "ChangeFeed.h"
+#include "AuditLog.h"
+#include "Validate.h"
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+static const char ARCHIVE_MAGIC[4] = {'S', 'A', 'R', 'C'};
+static const int ARCHIVE_VERSION = 1;
+static const int FILE_HEADER_BYTES = 4 + 1 + 2 + 4 + 4;
+static const int BLOCK_HEADER_BYTES = 4 + 2 + 8 + 8 + 2 + 2;
+static const unsigned char SCORE_ESCAPE = 255;
+
+// Largest packed 10-digit ID
+static const unsigned long long MAX_PACKED_ID = 9999999999ULL;
+
+// Append a variable-length integer (7 bits per byte)
+static void putVarint(string& buf, unsigned long long value) {
+    while (value >= 0x80) {
+        buf += (char)((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    buf += (char)value;
+}
+
+// Read a variable-length integer, returns false on truncated data
+static bool getVarint(const string& buf, size_t& pos, unsigned long long& value) {
+    value = 0;
+    int shift = 0;
+    while (pos < buf.size() && shift < 64) {
+        unsigned char b = (unsigned char)buf[pos++];
+        value |= (unsigned long long)(b & 0x7F) << shift;
+        if ((b & 0x80) == 0) {
+            return true;
+        }
+        shift += 7;
+    }
+    return false;
+}
+
+// Append a fixed-width little-endian integer
+static void putFixed(string& buf, unsigned long long value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        buf += (char)((value >> (8 * i)) & 0xFF);
+    }
+}
+
+// Read a fixed-width little-endian integer
+static unsigned long long getFixed(const char* data, int bytes) {
+    unsigned long long value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= (unsigned long long)(unsigned char)data[i] << (8 * i);
+    }
+    return value;
+}
+
+// Encode students list[order[start]] .. list[order[start + count - 1]] into one block
+static void encodeBlock(const Student* const* list, const int* order, int start, int count,
+                        string& block) {
+    string payload;
+    ArchiveBlockInfo info;
+    info.minId = packStudentId(list[order[start]]->getStudentId());
+    info.maxId = packStudentId(list[order[start + count - 1]]->getStudentId());
+    info.minAvg = 100.0;
+    info.maxAvg = 0.0;
+
+    // Build the name dictionary for this block
+    string* names = new string[count];
+    int* nameIndex = new int[count];
+    int nameCount = 0;
+    for (int i = 0; i < count; i++) {
+        string n = list[order[start + i]]->getName();
+        int k = 0;
+        while (k < nameCount && names[k] != n) {
+            k++;
+        }
+        if (k == nameCount) {
+            names[nameCount++] = n;
+        }
+        nameIndex[i] = k;
+    }
+    putVarint(payload, nameCount);
+    for (int k = 0; k < nameCount; k++) {
+        payload += (char)names[k].length();
+        payload += names[k];
+    }
+
+    // Encode students
+    unsigned long long prevId = 0;
+    for (int i = 0; i < count; i++) {
+        const Student& s = *list[order[start + i]];
+        unsigned long long id = packStudentId(s.getStudentId());
+        putVarint(payload, id - prevId);
+        prevId = id;
+        putVarint(payload, nameIndex[i]);
+        payload += (char)s.getAge();
+        int flags = (s.getGender() == 'F' ? 1 : 0) | (s.getCourseCount() << 1);
+        payload += (char)flags;
+        for (int c = 0; c < s.getCourseCount(); c++) {
+            double score = s.getScore(c);
+            double half = score * 2;
+            if (half == floor(half) && half >= 0 && half <= 200) {
+                payload += (char)(int)half;
+            } else {
+                unsigned long long bits;
+                memcpy(&bits, &score, sizeof(bits));
+                payload += (char)SCORE_ESCAPE;
+                putFixed(payload, bits, 8);
+            }
+        }
+        if (s.getAvgScore() < info.minAvg) info.minAvg = s.getAvgScore();
+        if (s.getAvgScore() > info.maxAvg) info.maxAvg = s.getAvgScore();
+    }
+
+    delete[] names;
+    delete[] nameIndex;
+
+    putFixed(block, payload.size(), 4);
+    putFixed(block, count, 2);
+    putFixed(block, info.minId, 8);
+    putFixed(block, info.maxId, 8);
+    putFixed(block, (unsigned long long)floor(info.minAvg * 10), 2);
+    putFixed(block, (unsigned long long)ceil(info.maxAvg * 10), 2);
+    block += payload;
+}
+
+// Decode one block payload into out[0 .. count-1]. The fields are parsed
+// into columns first and checked with the Validate.h column validators, so
+// a damaged block is rejected instead of producing invalid students.
+static bool decodeBlock(const string& payload, int count, Student* out) {
+    size_t pos = 0;
+    unsigned long long value;
+
+    if (!getVarint(payload, pos, value)) return false;
+    // Every name takes at least its length byte
+    if (value > payload.size() - pos) return false;
+    int nameCount = (int)value;
+    string* names = new string[nameCount > 0 ? nameCount : 1];
+    for (int k = 0; k < nameCount; k++) {
+        if (pos >= payload.size()) {
+            delete[] names;
+            return false;
+        }
+        size_t len = (unsigned char)payload[pos++];
+        if (pos + len > payload.size()) {
+            delete[] names;
+            return false;
+        }
+        names[k] = payload.substr(pos, len);
+        pos += len;
+    }
+
+    unsigned long long* ids = new unsigned long long[count];
+    int* nameIndex = new int[count];
+    int* ages = new int[count];
+    int* flags = new int[count];
+    double* scores = new double[count * 5];     // 5 per student, unused courses are 0
+    bool ok = true;
+    unsigned long long prevId = 0;
+    for (int i = 0; i < count && ok; i++) {
+        unsigned long long delta;
+        unsigned long long nameK;
+        if (!getVarint(payload, pos, delta) || !getVarint(payload, pos, nameK)
+            || nameK >= (unsigned long long)nameCount || pos + 2 > payload.size()) {
+            ok = false;
+            break;
+        }
+        prevId += delta;
+        ids[i] = prevId;
+        nameIndex[i] = (int)nameK;
+        ages[i] = (unsigned char)payload[pos++];
+        flags[i] = (unsigned char)payload[pos++];
+        int courseCount = flags[i] >> 1;
+        // 10-digit IDs, 3 or 5 courses, ages as accepted by Student::setAge
+        if (prevId > MAX_PACKED_ID || (courseCount != 3 && courseCount != 5)
+            || ages[i] == 0 || ages[i] > 150) {
+            ok = false;
+            break;
+        }
+        for (int c = 0; c < 5; c++) {
+            scores[i * 5 + c] = 0.0;
+        }
+        for (int c = 0; c < courseCount; c++) {
+            if (pos >= payload.size()) {
+                ok = false;
+                break;
+            }
+            unsigned char b = (unsigned char)payload[pos++];
+            double score;
+            if (b == SCORE_ESCAPE) {
+                if (pos + 8 > payload.size()) {
+                    ok = false;
+                    break;
+                }
+                unsigned long long bits = getFixed(payload.data() + pos, 8);
+                memcpy(&score, &bits, sizeof(score));
+                pos += 8;
+            } else {
+                score = b / 2.0;
+            }
+            scores[i * 5 + c] = score;
+        }
+    }
+
+    if (ok) {
+        unsigned long long* nameErrors = new unsigned long long[errorBitmapWords(nameCount) + 1];
+        unsigned long long* scoreErrors = new unsigned long long[errorBitmapWords(count * 5)];
+        clearErrorBitmap(nameErrors, nameCount);
+        clearErrorBitmap(scoreErrors, count * 5);
+        ok = validateNameColumn(names, nameCount, nameErrors) == 0
+            && validateScoreColumn(scores, count * 5, scoreErrors) == 0;
+        delete[] nameErrors;
+        delete[] scoreErrors;
+    }
+
+    if (ok) {
+        // Decoded students are not roster members, do not notify or audit
+        ChangeFeedMute mute;
+        AuditMute auditMute;
+        for (int i = 0; i < count; i++) {
+            int courseCount = flags[i] >> 1;
+            char gender = (flags[i] & 1) ? 'F' : 'M';
+            out[i] = Student(unpackStudentId(ids[i]), names[nameIndex[i]], ages[i], gender, courseCount);
+            for (int c = 0; c < courseCount; c++) {
+                out[i].setScore(c, scores[i * 5 + c]);
+            }
+            out[i].calcAverage();
+        }
+    }
+
+    delete[] names;
+    delete[] ids;
+    delete[] nameIndex;
+    delete[] ages;
+    delete[] flags;
+    delete[] scores;
+    return ok;
+}
+
+// Read the payload of one block
+static bool readPayload(ifstream& file, const ArchiveBlockInfo& info, string& payload) {
+    payload.assign(info.payloadBytes, '\0');
+    file.clear();
+    file.seekg(info.offset);
+    file.read(&payload[0], info.payloadBytes);
+    return (bool)file;
+}
+
+// Encode an archive, writing to a file stream or to an async writer
+static bool encodeArchive(const Student* const* list, int count, ofstream* file,
+                          AsyncWriter* writer, int handle) {
+    // Sort by packed ID so deltas stay small and block ID ranges do not overlap
+    unsigned long long* keys = new unsigned long long[count > 0 ? count : 1];
+    int* order = new int[count > 0 ? count : 1];
+    for (int i = 0; i < count; i++) {
+        keys[i] = packStudentId(list[i]->getStudentId());
+        order[i] = i;
+    }
+    sort(order, order + count, [keys](int a, int b) { return keys[a] < keys[b]; });
+
+    int blockCount = (count + ARCHIVE_BLOCK_SIZE - 1) / ARCHIVE_BLOCK_SIZE;
+    string data(ARCHIVE_MAGIC, 4);
+    putFixed(data, ARCHIVE_VERSION, 1);
+    putFixed(data, ARCHIVE_BLOCK_SIZE, 2);
+    putFixed(data, count, 4);
+    putFixed(data, blockCount, 4);
+
+    // Header goes out together with the first block
+    bool ok = true;
+    int start = 0;
+    do {
+        int n = count - start;
+        if (n > ARCHIVE_BLOCK_SIZE) n = ARCHIVE_BLOCK_SIZE;
+        if (n > 0) {
+            encodeBlock(list, order, start, n, data);
+        }
+        if (file != nullptr) {
+            file->write(data.data(), data.size());
+            ok = (bool)*file;
+        } else {
+            ok = writer->write(handle, data);
+        }
+        data.clear();
+        start += ARCHIVE_BLOCK_SIZE;
+    } while (start < count && ok);
+
+    delete[] keys;
+    delete[] order;
+    return ok;
+}
+
+// Write students to an archive file
+bool writeArchive(const string& fileName, const Student* const* list, int count) {
+    ofstream file(fileName.c_str(), ios::binary | ios::trunc);
+    if (!file) {
+        return false;
+    }
+    return encodeArchive(list, count, &file, nullptr, -1);
+}
+
+// Encode an archive and queue it on an async writer
+bool writeArchive(AsyncWriter& writer, int handle, const Student* const* list, int count) {
+    return encodeArchive(list, count, nullptr, &writer, handle);
+}
+
+// Read only the block index of an archive
+bool readArchiveIndex(const string& fileName, ArchiveBlockInfo*& blocks, int& blockCount, int& totalCount) {
+    blocks = nullptr;
+    blockCount = 0;
+    totalCount = 0;
+
+    ifstream file(fileName.c_str(), ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    char header[FILE_HEADER_BYTES];
+    file.read(header, FILE_HEADER_BYTES);
+    if (!file || memcmp(header, ARCHIVE_MAGIC, 4) != 0
+        || (int)getFixed(header + 4, 1) != ARCHIVE_VERSION) {
+        return false;
+    }
+    // Counts come from the file: bound them by the file size before
+    // allocating, a damaged header must not cause a huge allocation
+    file.seekg(0, ios::end);
+    long long fileSize = (long long)file.tellg();
+    int blockSize = (int)getFixed(header + 5, 2);
+    long long storedTotal = (long long)getFixed(header + 7, 4);
+    long long storedBlocks = (long long)getFixed(header + 11, 4);
+    if (blockSize <= 0 || storedBlocks > (fileSize - FILE_HEADER_BYTES) / BLOCK_HEADER_BYTES
+        || storedTotal > storedBlocks * blockSize) {
+        return false;
+    }
+    totalCount = (int)storedTotal;
+    blockCount = (int)storedBlocks;
+    blocks = new ArchiveBlockInfo[blockCount > 0 ? blockCount : 1];
+
+    long long offset = FILE_HEADER_BYTES;
+    long long counted = 0;
+    for (int b = 0; b < blockCount; b++) {
+        char bh[BLOCK_HEADER_BYTES];
+        file.seekg(offset);
+        file.read(bh, BLOCK_HEADER_BYTES);
+        if (!file) {
+            delete[] blocks;
+            blocks = nullptr;
+            return false;
+        }
+        ArchiveBlockInfo& info = blocks[b];
+        info.payloadBytes = (int)getFixed(bh, 4);
+        info.count = (int)getFixed(bh + 4, 2);
+        info.minId = getFixed(bh + 6, 8);
+        info.maxId = getFixed(bh + 14, 8);
+        info.minAvg = getFixed(bh + 22, 2) / 10.0;
+        info.maxAvg = getFixed(bh + 24, 2) / 10.0;
+        info.offset = offset + BLOCK_HEADER_BYTES;
+        // Skip the payload without reading it
+        offset = info.offset + info.payloadBytes;
+        if (info.count <= 0 || info.count > blockSize || info.payloadBytes < 0
+            || offset > fileSize) {
+            delete[] blocks;
+            blocks = nullptr;
+            return false;
+        }
+        counted += info.count;
+    }
+    if (counted != totalCount) {
+        delete[] blocks;
+        blocks = nullptr;
+        return false;
+    }
+    return true;
+}
+
+// Find one student by ID
+bool findInArchive(const string& fileName, const string& id, Student& result, int& blocksRead) {
+    blocksRead = 0;
+    if (!isValidId(id)) {
+        return false;
+    }
+    ArchiveBlockInfo* blocks;
+    int blockCount;
+    int totalCount;
+    if (!readArchiveIndex(fileName, blocks, blockCount, totalCount)) {
+        return false;
+    }
+
+    unsigned long long key = packStudentId(id);
+    ifstream file(fileName.c_str(), ios::binary);
+    bool found = false;
+    string payload;
+    for (int b = 0; b < blockCount && !found; b++) {
+        if (key < blocks[b].minId || key > blocks[b].maxId) {
+            continue;
+        }
+        Student* decoded = new Student[blocks[b].count];
+        blocksRead++;
+        if (readPayload(file, blocks[b], payload)
+            && decodeBlock(payload, blocks[b].count, decoded)) {
+            for (int i = 0; i < blocks[b].count; i++) {
+                if (decoded[i].getStudentId() == id) {
+                    result = decoded[i];
+                    found = true;
+                    break;
+                }
+            }
+        }
+        delete[] decoded;
+    }
+    delete[] blocks;
+    return found;
+}
+
+// Find students with average in [low, high]
+int queryArchiveByAverage(const string& fileName, double low, double high,
+                          Student*& results, int& blocksRead) {
+    results = nullptr;
+    blocksRead = 0;
+    ArchiveBlockInfo* blocks;
+    int blockCount;
+    int totalCount;
+    if (!readArchiveIndex(fileName, blocks, blockCount, totalCount)) {
+        return -1;
+    }
+
+    ifstream file(fileName.c_str(), ios::binary);
+    int capacity = 16;
+    int found = 0;
+    results = new Student[capacity];
+    string payload;
+    for (int b = 0; b < blockCount; b++) {
+        if (blocks[b].maxAvg < low || blocks[b].minAvg > high) {
+            continue;
+        }
+        Student* decoded = new Student[blocks[b].count];
+        blocksRead++;
+        if (readPayload(file, blocks[b], payload)
+            && decodeBlock(payload, blocks[b].count, decoded)) {
+            for (int i = 0; i < blocks[b].count; i++) {
+                double avg = decoded[i].getAvgScore();
+                if (avg < low || avg > high) {
+                    continue;
+                }
+                if (found == capacity) {
+                    Student* bigger = new Student[capacity * 2];
+                    for (int k = 0; k < found; k++) {
+                        bigger[k] = results[k];
+                    }
+                    delete[] results;
+                    results = bigger;
+                    capacity *= 2;
+                }
+                results[found++] = decoded[i];
+            }
+        }
+        delete[] decoded;
+    }
+    delete[] blocks;
+    return found;
+}
@@ -0,0 +1,40 @@
+// Archive.h - Compressed block archive for historical rosters
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include "Student.h"
+#include "AsyncWriter.h"
+
+// Number of students stored in one archive block
+const int ARCHIVE_BLOCK_SIZE = 128;
+
+// Index entry for one block (read from the block header only)
+struct ArchiveBlockInfo {
+    long long offset;            // file offset of the block payload
+    int payloadBytes;            // encoded payload size
+    int count;                   // students in this block
+    unsigned long long minId;    // smallest packed ID in the block
+    unsigned long long maxId;    // largest packed ID in the block
+    double minAvg;               // lower bound of average scores
+    double maxAvg;               // upper bound of average scores
+};
+
+// Write students to an archive file (students are stored sorted by ID)
+bool writeArchive(const string& fileName, const Student* const* list, int count);
+
+// Encode an archive and queue it on a file opened with writer.openFile().
+// Returns false if the file cannot be written (check with writer.waitFile()).
+bool writeArchive(AsyncWriter& writer, int handle, const Student* const* list, int count);
+
+// Read only the block index of an archive, caller must delete[] blocks.
+// Returns false for damaged files (counts that do not fit the file size).
+bool readArchiveIndex(const string& fileName, ArchiveBlockInfo*& blocks, int& blockCount, int& totalCount);
+
+// Find one student by ID, decoding only blocks whose ID range matches
+bool findInArchive(const string& fileName, const string& id, Student& result, int& blocksRead);
+
+// Find students with average in [low, high], caller must delete[] results
+int queryArchiveByAverage(const string& fileName, double low, double high,
+                          Student*& results, int& blocksRead);
+
+#endif // ARCHIVE_H
@@ -0,0 +1,411 @@
+// AsyncWriter.cpp - Background file writer for snapshots, logs and exports
+#include "AsyncWriter.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#define SYNC_FILE(f) _commit(_fileno(f))
+#else
+#include <unistd.h>
+#define SYNC_FILE(f) fsync(fileno(f))
+#endif
+
+// Constructor - allocate the buffer pool and start the workers
+AsyncWriter::AsyncWriter(int threadCount) {
+    workerCount = threadCount > 0 ? threadCount : 1;
+    bytesWritten = 0;
+    batches = 0;
+    requests = 0;
+    errors = 0;
+    failedCount = 0;
+
+    for (int h = 0; h < ASYNC_MAX_FILES; h++) {
+        files[h].used = false;
+        files[h].file = nullptr;
+        files[h].pending = nullptr;
+        files[h].pendingLength = 0;
+        files[h].submitted = 0;
+        files[h].completed = 0;
+        files[h].failed = false;
+    }
+
+    bufferMemory = new char[(size_t)ASYNC_BUFFER_SIZE * ASYNC_BUFFER_COUNT];
+    for (int i = 0; i < ASYNC_BUFFER_COUNT; i++) {
+        freeBuffers[i] = bufferMemory + (size_t)i * ASYNC_BUFFER_SIZE;
+    }
+    freeCount = ASYNC_BUFFER_COUNT;
+
+    workers = new Worker[workerCount];
+    for (int i = 0; i < workerCount; i++) {
+        workers[i].head = 0;
+        workers[i].count = 0;
+        workers[i].stopping = false;
+        workers[i].worker = thread(&AsyncWriter::runWorker, this, i);
+    }
+}
+
+// Destructor - close open files, finish queued writes, stop the workers
+AsyncWriter::~AsyncWriter() {
+    for (int h = 0; h < ASYNC_MAX_FILES; h++) {
+        if (files[h].used) {
+            closeFile(h);
+        }
+    }
+    for (int i = 0; i < workerCount; i++) {
+        {
+            lock_guard<mutex> guard(workers[i].lock);
+            workers[i].stopping = true;
+        }
+        workers[i].ready.notify_all();
+    }
+    for (int i = 0; i < workerCount; i++) {
+        workers[i].worker.join();
+    }
+    delete[] workers;
+    delete[] bufferMemory;
+}
+
+// Take a buffer from the pool, waiting if all are in flight
+char* AsyncWriter::acquireBuffer() {
+    unique_lock<mutex> guard(poolLock);
+    while (freeCount == 0) {
+        poolReady.wait(guard);
+    }
+    return freeBuffers[--freeCount];
+}
+
+// Take a buffer from the pool, nullptr if all are in use
+char* AsyncWriter::tryAcquireBuffer() {
+    lock_guard<mutex> guard(poolLock);
+    if (freeCount == 0) {
+        return nullptr;
+    }
+    return freeBuffers[--freeCount];
+}
+
+// Return a buffer to the pool
+void AsyncWriter::releaseBuffer(char* buffer) {
+    {
+        lock_guard<mutex> guard(poolLock);
+        freeBuffers[freeCount++] = buffer;
+    }
+    poolReady.notify_one();
+}
+
+// Queue a request on the worker that owns the file
+void AsyncWriter::enqueue(const Request& req) {
+    files[req.handle].submitted++;
+    Worker& w = workers[req.handle % workerCount];
+    {
+        unique_lock<mutex> guard(w.lock);
+        while (w.count == ASYNC_QUEUE_SIZE) {
+            w.space.wait(guard);
+        }
+        w.queue[(w.head + w.count) % ASYNC_QUEUE_SIZE] = req;
+        w.count++;
+    }
+    w.ready.notify_one();
+}
+
+// Queue the partly filled buffer of a file (fileLock held)
+void AsyncWriter::submitPending(int handle) {
+    FileSlot& f = files[handle];
+    if (f.pending == nullptr) {
+        return;
+    }
+    Request req;
+    req.type = REQ_WRITE;
+    req.handle = handle;
+    req.buffer = f.pending;
+    req.length = f.pendingLength;
+    req.append = false;
+    f.pending = nullptr;
+    f.pendingLength = 0;
+    enqueue(req);
+}
+
+// Worker loop: take every queued request, run them as one batch
+void AsyncWriter::runWorker(int index) {
+    Worker& w = workers[index];
+    Request batch[ASYNC_QUEUE_SIZE];
+    while (true) {
+        int n = 0;
+        {
+            unique_lock<mutex> guard(w.lock);
+            while (w.count == 0 && !w.stopping) {
+                w.ready.wait(guard);
+            }
+            if (w.count == 0 && w.stopping) {
+                return;
+            }
+            while (w.count > 0) {
+                batch[n++] = w.queue[w.head];
+                w.head = (w.head + 1) % ASYNC_QUEUE_SIZE;
+                w.count--;
+            }
+        }
+        w.space.notify_all();
+
+        for (int i = 0; i < n; i++) {
+            execute(batch[i]);
+        }
+        // One flush per file touched by the batch
+        bool touched[ASYNC_MAX_FILES] = { false };
+        for (int i = 0; i < n; i++) {
+            if (batch[i].type == REQ_WRITE) {
+                touched[batch[i].handle] = true;
+            }
+        }
+        for (int h = 0; h < ASYNC_MAX_FILES; h++) {
+            if (touched[h] && files[h].file != nullptr && fflush(files[h].file) != 0) {
+                files[h].failed = true;
+                errors++;
+            }
+        }
+        batches++;
+        requests += n;
+
+        {
+            lock_guard<mutex> guard(doneLock);
+            for (int i = 0; i < n; i++) {
+                files[batch[i].handle].completed++;
+            }
+        }
+        done.notify_all();
+    }
+}
+
+// Run one request on the worker thread
+void AsyncWriter::execute(Request& req) {
+    FileSlot& f = files[req.handle];
+    switch (req.type) {
+        case REQ_OPEN:
+            f.failed = false;
+            f.file = fopen(f.fileName.c_str(), req.append ? "ab" : "wb");
+            if (f.file == nullptr) {
+                f.failed = true;
+                errors++;
+            }
+            break;
+        case REQ_WRITE:
+            if (f.file != nullptr) {
+                if (fwrite(req.buffer, 1, req.length, f.file) != req.length) {
+                    f.failed = true;
+                    errors++;
+                } else {
+                    bytesWritten += req.length;
+                }
+            }
+            releaseBuffer(req.buffer);
+            break;
+        case REQ_SYNC:
+            if (f.file != nullptr) {
+                fflush(f.file);
+                SYNC_FILE(f.file);
+            }
+            break;
+        case REQ_CLOSE:
+            if (f.file != nullptr) {
+                if (fclose(f.file) != 0) {
+                    f.failed = true;
+                    errors++;
+                }
+                f.file = nullptr;
+                // Open failures are seen by the caller through waitFile()
+                if (f.failed) {
+                    lock_guard<mutex> guard(failedLock);
+                    if (failedCount < ASYNC_MAX_FAILED) {
+                        failedNames[failedCount++] = f.fileName;
+                    }
+                }
+            }
+            break;
+    }
+}
+
+// Open a file for writing
+int AsyncWriter::openFile(const string& fileName, bool append) {
+    lock_guard<mutex> guard(fileLock);
+    for (int h = 0; h < ASYNC_MAX_FILES; h++) {
+        if (!files[h].used) {
+            // Earlier requests on this handle must finish before it is reused
+            unique_lock<mutex> wait(doneLock);
+            while (files[h].completed.load() != files[h].submitted.load()) {
+                done.wait(wait);
+            }
+            wait.unlock();
+
+            files[h].used = true;
+            files[h].fileName = fileName;
+            Request req;
+            req.type = REQ_OPEN;
+            req.handle = h;
+            req.buffer = nullptr;
+            req.length = 0;
+            req.append = append;
+            enqueue(req);
+            return h;
+        }
+    }
+    return -1;
+}
+
+// Copy data into the file's buffer, queueing full buffers
+bool AsyncWriter::write(int handle, const char* data, size_t length) {
+    if (handle < 0 || handle >= ASYNC_MAX_FILES) {
+        return false;
+    }
+    unique_lock<mutex> guard(fileLock);
+    FileSlot& f = files[handle];
+    if (!f.used) {
+        return false;
+    }
+    while (length > 0) {
+        if (f.pending == nullptr) {
+            char* buffer = tryAcquireBuffer();
+            if (buffer == nullptr) {
+                // Every buffer is queued or partly filled. Queue the partly
+                // filled ones so the workers return them, and wait without
+                // fileLock so flush and close on other files can go on.
+                for (int h = 0; h < ASYNC_MAX_FILES; h++) {
+                    submitPending(h);
+                }
+                guard.unlock();
+                buffer = acquireBuffer();
+                guard.lock();
+                if (!f.used) {
+                    releaseBuffer(buffer);
+                    return false;
+                }
+                if (f.pending != nullptr) {
+                    // Another write to this file took a buffer meanwhile
+                    releaseBuffer(buffer);
+                    continue;
+                }
+            }
+            f.pending = buffer;
+            f.pendingLength = 0;
+        }
+        size_t room = ASYNC_BUFFER_SIZE - f.pendingLength;
+        size_t n = length < room ? length : room;
+        memcpy(f.pending + f.pendingLength, data, n);
+        f.pendingLength += n;
+        data += n;
+        length -= n;
+        if (f.pendingLength == (size_t)ASYNC_BUFFER_SIZE) {
+            submitPending(handle);
+        }
+    }
+    return true;
+}
+
+bool AsyncWriter::write(int handle, const string& data) {
+    return write(handle, data.data(), data.size());
+}
+
+// Queue the partly filled buffer of a file
+void AsyncWriter::flush(int handle) {
+    if (handle < 0 || handle >= ASYNC_MAX_FILES) {
+        return;
+    }
+    lock_guard<mutex> guard(fileLock);
+    if (files[handle].used) {
+        submitPending(handle);
+    }
+}
+
+// Queue a flush to stable storage
+void AsyncWriter::sync(int handle) {
+    if (handle < 0 || handle >= ASYNC_MAX_FILES) {
+        return;
+    }
+    lock_guard<mutex> guard(fileLock);
+    if (!files[handle].used) {
+        return;
+    }
+    submitPending(handle);
+    Request req;
+    req.type = REQ_SYNC;
+    req.handle = handle;
+    req.buffer = nullptr;
+    req.length = 0;
+    req.append = false;
+    enqueue(req);
+}
+
+// Queue the close of a file
+void AsyncWriter::closeFile(int handle) {
+    if (handle < 0 || handle >= ASYNC_MAX_FILES) {
+        return;
+    }
+    lock_guard<mutex> guard(fileLock);
+    if (!files[handle].used) {
+        return;
+    }
+    submitPending(handle);
+    Request req;
+    req.type = REQ_CLOSE;
+    req.handle = handle;
+    req.buffer = nullptr;
+    req.length = 0;
+    req.append = false;
+    enqueue(req);
+    files[handle].used = false;
+}
+
+// Wait until every request queued for a file has completed
+bool AsyncWriter::waitFile(int handle) {
+    if (handle < 0 || handle >= ASYNC_MAX_FILES) {
+        return false;
+    }
+    unique_lock<mutex> guard(doneLock);
+    while (files[handle].completed.load() != files[handle].submitted.load()) {
+        done.wait(guard);
+    }
+    return !files[handle].failed;
+}
+
+// Wait until all queued requests have completed
+void AsyncWriter::drain() {
+    for (int h = 0; h < ASYNC_MAX_FILES; h++) {
+        waitFile(h);
+    }
+}
+
+bool AsyncWriter::hasFailed(int handle) const {
+    return files[handle].failed;
+}
+
+// Names of closed files that failed since the last call
+int AsyncWriter::takeFailedFiles(string* names, int max) {
+    lock_guard<mutex> guard(failedLock);
+    int n = failedCount < max ? failedCount : max;
+    for (int i = 0; i < n; i++) {
+        names[i] = failedNames[i];
+    }
+    for (int i = n; i < failedCount; i++) {
+        failedNames[i - n] = failedNames[i];
+    }
+    failedCount -= n;
+    return n;
+}
+
+unsigned long long AsyncWriter::getBytesWritten() const {
+    return bytesWritten;
+}
+
+unsigned long long AsyncWriter::getBatches() const {
+    return batches;
+}
+
+unsigned long long AsyncWriter::getRequests() const {
+    return requests;
+}
+
+unsigned long long AsyncWriter::getErrors() const {
+    return errors;
+}
+
+int AsyncWriter::getWorkerCount() const {
+    return workerCount;
+}
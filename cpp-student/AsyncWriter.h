@@ -0,0 +1,150 @@
+// AsyncWriter.h - Background file writer for snapshots, logs and exports
+#ifndef ASYNCWRITER_H
+#define ASYNCWRITER_H
+
+#include <string>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+using namespace std;
+
+// Size and number of preallocated write buffers
+const int ASYNC_BUFFER_SIZE = 1 << 20;
+const int ASYNC_BUFFER_COUNT = 16;
+
+// Open files at the same time
+const int ASYNC_MAX_FILES = 64;
+
+// Requests waiting per worker
+const int ASYNC_QUEUE_SIZE = 256;
+
+// Failed files remembered until takeFailedFiles() is called
+const int ASYNC_MAX_FAILED = 16;
+
+// Writes files on worker threads. Small writes to a file are gathered into
+// one buffer on the caller side; full buffers are queued and each worker
+// writes all queued requests in one batch before flushing. A file is always
+// handled by the same worker, so its writes stay in order.
+class AsyncWriter {
+private:
+    enum RequestType { REQ_OPEN, REQ_WRITE, REQ_SYNC, REQ_CLOSE };
+
+    struct Request {
+        int type;
+        int handle;
+        char* buffer;            // REQ_WRITE: buffer from the pool
+        size_t length;
+        bool append;             // REQ_OPEN
+    };
+
+    struct Worker {
+        thread worker;
+        mutex lock;
+        condition_variable ready;    // requests queued or stopping
+        condition_variable space;    // queue has room
+        Request queue[ASYNC_QUEUE_SIZE];
+        int head;
+        int count;
+        bool stopping;
+    };
+
+    // Caller-side state of one file
+    struct FileSlot {
+        bool used;
+        string fileName;
+        FILE* file;                      // owned by the worker
+        char* pending;                   // buffer being filled by the caller
+        size_t pendingLength;
+        atomic<unsigned long long> submitted;
+        atomic<unsigned long long> completed;
+        atomic<bool> failed;
+    };
+
+    Worker* workers;
+    int workerCount;
+    FileSlot files[ASYNC_MAX_FILES];
+    mutex fileLock;                  // protects caller-side file state
+    mutex doneLock;
+    condition_variable done;         // a request completed
+
+    // Buffer pool
+    char* bufferMemory;
+    char* freeBuffers[ASYNC_BUFFER_COUNT];
+    int freeCount;
+    mutex poolLock;
+    condition_variable poolReady;
+
+    // Opened files whose write or close failed, kept until taken
+    string failedNames[ASYNC_MAX_FAILED];
+    int failedCount;
+    mutex failedLock;
+
+    // Statistics
+    atomic<unsigned long long> bytesWritten;
+    atomic<unsigned long long> batches;
+    atomic<unsigned long long> requests;
+    atomic<unsigned long long> errors;
+
+    // Not copyable
+    AsyncWriter(const AsyncWriter& other);
+    AsyncWriter& operator=(const AsyncWriter& other);
+
+    char* acquireBuffer();
+    char* tryAcquireBuffer();
+    void releaseBuffer(char* buffer);
+    void enqueue(const Request& req);
+    void submitPending(int handle);
+    void runWorker(int index);
+    void execute(Request& req);
+
+public:
+    // Start the given number of worker threads
+    AsyncWriter(int threadCount);
+
+    // Finish all queued writes and stop the workers
+    ~AsyncWriter();
+
+    // Open a file for writing (truncate or append), -1 if no free handle.
+    // Open errors are reported by hasFailed() and waitFile().
+    int openFile(const string& fileName, bool append);
+
+    // Copy data into the file's buffer, queueing full buffers.
+    // When every pool buffer is in use, the partly filled buffers of all
+    // files are queued and the call waits for one to come back.
+    bool write(int handle, const char* data, size_t length);
+    bool write(int handle, const string& data);
+
+    // Queue the partly filled buffer of a file
+    void flush(int handle);
+
+    // Queue a flush to stable storage (fsync)
+    void sync(int handle);
+
+    // Queue the close of a file, the handle may be reused afterwards
+    void closeFile(int handle);
+
+    // Wait until every request queued for a file has completed,
+    // returns false if any of them failed
+    bool waitFile(int handle);
+
+    // Wait until all queued requests have completed
+    void drain();
+
+    bool hasFailed(int handle) const;
+
+    // Names of files closed since the last call whose write or close
+    // failed; returns how many were copied (at most max)
+    int takeFailedFiles(string* names, int max);
+
+    // Statistics
+    unsigned long long getBytesWritten() const;
+    unsigned long long getBatches() const;
+    unsigned long long getRequests() const;
+    unsigned long long getErrors() const;
+    int getWorkerCount() const;
+};
+
+#endif // ASYNCWRITER_H
@@ -0,0 +1,614 @@
+// AuditLog.cpp - Tamper-evident audit trail of grade changes
+//
+// File layout:
+//   header : "SAUD", version (4 bytes)
+//   blocks : block header (112 bytes) followed by its entries (56 bytes each)
+//
+// Block header: entry count (4), reserved (4), first sequence (8),
+// previous block hash (32), Merkle root (32), block hash (32).
+//
+// Hashes (all SHA-256):
+//   leaf       = H(0x00 | entry)
+//   node       = H(0x01 | left | right), an odd last node moves up unchanged
+//   block hash = H(0x02 | count | first sequence | previous hash | root)
+// The first block uses a previous hash of 32 zero bytes. Changing an entry
+// changes its block's root; changing a header breaks the chain after it.
+#include "AuditLog.h"
+#include "Student.h"
+#include <fstream>
+#include <chrono>
+#include <ctime>
+#include <cstring>
+
+static const char AUDIT_MAGIC[4] = {'S', 'A', 'U', 'D'};
+static const unsigned int AUDIT_VERSION = 1;
+static const int AUDIT_FILE_HEADER_BYTES = 8;
+static const int AUDIT_BLOCK_HEADER_BYTES = 112;
+static const char CHECKPOINT_MAGIC[4] = {'S', 'A', 'V', 'C'};
+
+// Block header as read from a file
+struct AuditBlockInfo {
+    long long offset;                // file offset of the block header
+    int count;
+    unsigned long long firstSequence;
+    unsigned char prevHash[SHA256_BYTES];
+    unsigned char root[SHA256_BYTES];
+    unsigned char hash[SHA256_BYTES];
+};
+
+static void hashLeaf(const AuditEntry& e, unsigned char* out) {
+    Sha256 h;
+    unsigned char tag = 0;
+    h.update(&tag, 1);
+    h.update(&e, sizeof(AuditEntry));
+    h.final(out);
+}
+
+static void hashNode(const unsigned char* left, const unsigned char* right, unsigned char* out) {
+    Sha256 h;
+    unsigned char tag = 1;
+    h.update(&tag, 1);
+    h.update(left, SHA256_BYTES);
+    h.update(right, SHA256_BYTES);
+    h.final(out);
+}
+
+// Merkle root of a batch of entries
+static void merkleRoot(const AuditEntry* entries, int count, unsigned char* root) {
+    unsigned char level[AUDIT_BATCH_SIZE][SHA256_BYTES];
+    for (int i = 0; i < count; i++) {
+        hashLeaf(entries[i], level[i]);
+    }
+    int n = count;
+    while (n > 1) {
+        int next = 0;
+        for (int i = 0; i < n; i += 2) {
+            if (i + 1 < n) {
+                hashNode(level[i], level[i + 1], level[next]);
+            } else {
+                memcpy(level[next], level[i], SHA256_BYTES);
+            }
+            next++;
+        }
+        n = next;
+    }
+    memcpy(root, level[0], SHA256_BYTES);
+}
+
+// Hash that links a block to the one before it
+static void blockHashOf(const AuditBlockInfo& b, unsigned char* out) {
+    Sha256 h;
+    unsigned char tag = 2;
+    unsigned int count = (unsigned int)b.count;
+    h.update(&tag, 1);
+    h.update(&count, 4);
+    h.update(&b.firstSequence, 8);
+    h.update(b.prevHash, SHA256_BYTES);
+    h.update(b.root, SHA256_BYTES);
+    h.final(out);
+}
+
+static void encodeBlockHeader(const AuditBlockInfo& b, char* out) {
+    unsigned int count = (unsigned int)b.count;
+    unsigned int reserved = 0;
+    memcpy(out, &count, 4);
+    memcpy(out + 4, &reserved, 4);
+    memcpy(out + 8, &b.firstSequence, 8);
+    memcpy(out + 16, b.prevHash, SHA256_BYTES);
+    memcpy(out + 48, b.root, SHA256_BYTES);
+    memcpy(out + 80, b.hash, SHA256_BYTES);
+}
+
+static void decodeBlockHeader(const char* in, AuditBlockInfo& b) {
+    unsigned int count = 0;
+    memcpy(&count, in, 4);
+    b.count = (int)count;
+    memcpy(&b.firstSequence, in + 8, 8);
+    memcpy(b.prevHash, in + 16, SHA256_BYTES);
+    memcpy(b.root, in + 48, SHA256_BYTES);
+    memcpy(b.hash, in + 80, SHA256_BYTES);
+}
+
+// Read every block header of a log, caller must delete[] blocks.
+// A missing or empty file has no header and no blocks. Returns false if the
+// file is not an audit log or ends inside a block.
+static bool readBlockInfos(const string& fileName, AuditBlockInfo*& blocks, long long& blockCount,
+                           bool& hasHeader, string& problem) {
+    blocks = nullptr;
+    blockCount = 0;
+    hasHeader = false;
+    ifstream file(fileName.c_str(), ios::binary);
+    if (!file) {
+        return true;
+    }
+    file.seekg(0, ios::end);
+    long long size = (long long)file.tellg();
+    if (size <= 0) {
+        return true;
+    }
+    file.seekg(0, ios::beg);
+    char header[AUDIT_FILE_HEADER_BYTES];
+    file.read(header, AUDIT_FILE_HEADER_BYTES);
+    unsigned int version = 0;
+    memcpy(&version, header + 4, 4);
+    if (!file || memcmp(header, AUDIT_MAGIC, 4) != 0 || version != AUDIT_VERSION) {
+        problem = "not an audit log file";
+        return false;
+    }
+    hasHeader = true;
+
+    long long capacity = 64;
+    blocks = new AuditBlockInfo[capacity];
+    long long offset = AUDIT_FILE_HEADER_BYTES;
+    while (offset < size) {
+        char raw[AUDIT_BLOCK_HEADER_BYTES];
+        if (offset + AUDIT_BLOCK_HEADER_BYTES > size) {
+            problem = "file ends inside a block header";
+            return false;
+        }
+        file.seekg(offset);
+        file.read(raw, AUDIT_BLOCK_HEADER_BYTES);
+        if (blockCount == capacity) {
+            AuditBlockInfo* bigger = new AuditBlockInfo[capacity * 2];
+            memcpy(bigger, blocks, capacity * sizeof(AuditBlockInfo));
+            delete[] blocks;
+            blocks = bigger;
+            capacity *= 2;
+        }
+        AuditBlockInfo& b = blocks[blockCount];
+        decodeBlockHeader(raw, b);
+        b.offset = offset;
+        long long blockBytes = AUDIT_BLOCK_HEADER_BYTES + (long long)b.count * sizeof(AuditEntry);
+        if (!file || b.count < 1 || b.count > AUDIT_BATCH_SIZE || offset + blockBytes > size) {
+            problem = "file ends inside a block";
+            return false;
+        }
+        blockCount++;
+        offset += blockBytes;
+    }
+    return true;
+}
+
+// Constructor
+AuditLog::AuditLog() : blockCount(0), entriesWritten(0) {
+    writer = nullptr;
+    handle = -1;
+    memset(operatorName, 0, sizeof(operatorName));
+    batchMemory = new AuditEntry[AUDIT_QUEUE_BATCHES * AUDIT_BATCH_SIZE];
+    fillBatch = -1;
+    fillCount = 0;
+    nextSequence = 0;
+    freeCount = 0;
+    queueHead = 0;
+    queueCount = 0;
+    sealing = false;
+    stopping = false;
+    memset(lastHash, 0, sizeof(lastHash));
+}
+
+// Destructor
+AuditLog::~AuditLog() {
+    close();
+    delete[] batchMemory;
+}
+
+// Open (or continue) a log file
+bool AuditLog::open(AsyncWriter& w, const string& name, const string& operatorName) {
+    close();
+    AuditBlockInfo* blocks;
+    long long n;
+    bool hasHeader;
+    string problem;
+    if (!readBlockInfos(name, blocks, n, hasHeader, problem)) {
+        delete[] blocks;
+        return false;
+    }
+    // The chain continues from the last block on disk
+    if (n > 0) {
+        nextSequence = blocks[n - 1].firstSequence + blocks[n - 1].count;
+        memcpy(lastHash, blocks[n - 1].hash, SHA256_BYTES);
+    } else {
+        nextSequence = 0;
+        memset(lastHash, 0, SHA256_BYTES);
+    }
+    blockCount = n;
+    delete[] blocks;
+
+    handle = w.openFile(name, true);
+    if (handle < 0) {
+        return false;
+    }
+    // The open runs on a writer thread; an unwritable path fails here
+    if (!w.waitFile(handle)) {
+        w.closeFile(handle);
+        handle = -1;
+        return false;
+    }
+    writer = &w;
+    fileName = name;
+    if (!hasHeader) {
+        char header[AUDIT_FILE_HEADER_BYTES];
+        memcpy(header, AUDIT_MAGIC, 4);
+        memcpy(header + 4, &AUDIT_VERSION, 4);
+        writer->write(handle, header, AUDIT_FILE_HEADER_BYTES);
+    }
+
+    memset(this->operatorName, 0, sizeof(this->operatorName));
+    memcpy(this->operatorName, operatorName.data(),
+           operatorName.length() < (size_t)AUDIT_OPERATOR_CHARS ? operatorName.length() : AUDIT_OPERATOR_CHARS);
+    entriesWritten = (long long)nextSequence;
+    fillBatch = -1;
+    fillCount = 0;
+    for (int i = 0; i < AUDIT_QUEUE_BATCHES; i++) {
+        freeBatches[i] = i;
+    }
+    freeCount = AUDIT_QUEUE_BATCHES;
+    queueHead = 0;
+    queueCount = 0;
+    sealing = false;
+    stopping = false;
+    sealer = thread(&AuditLog::runSealer, this);
+    return true;
+}
+
+// Seal the partial batch, wait for the sealing thread, close the file
+void AuditLog::close() {
+    if (handle < 0) {
+        return;
+    }
+    sealPending();
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    changed.notify_all();
+    sealer.join();
+    writer->closeFile(handle);
+    handle = -1;
+}
+
+bool AuditLog::isOpen() const {
+    return handle >= 0;
+}
+
+string AuditLog::getFileName() const {
+    return fileName;
+}
+
+// Take an empty batch, waiting if all are queued
+int AuditLog::takeFreeBatch() {
+    unique_lock<mutex> guard(lock);
+    while (freeCount == 0) {
+        changed.wait(guard);
+    }
+    return freeBatches[--freeCount];
+}
+
+// Queue the batch being filled for the sealing thread
+void AuditLog::submitBatch() {
+    {
+        lock_guard<mutex> guard(lock);
+        int tail = (queueHead + queueCount) % AUDIT_QUEUE_BATCHES;
+        queue[tail] = fillBatch;
+        queueCounts[tail] = fillCount;
+        queueCount++;
+    }
+    changed.notify_all();
+    fillBatch = -1;
+    fillCount = 0;
+}
+
+// Record one grade change
+void AuditLog::record(unsigned long long studentId, int course, double oldScore, double newScore) {
+    if (handle < 0) {
+        return;
+    }
+    if (fillBatch < 0) {
+        fillBatch = takeFreeBatch();
+    }
+    AuditEntry& e = batchMemory[fillBatch * AUDIT_BATCH_SIZE + fillCount];
+    e.sequence = nextSequence++;
+    e.timeMicros = chrono::duration_cast<chrono::microseconds>(
+        chrono::system_clock::now().time_since_epoch()).count();
+    e.studentId = studentId;
+    e.oldScore = oldScore;
+    e.newScore = newScore;
+    memcpy(e.operatorName, operatorName, AUDIT_OPERATOR_CHARS);
+    e.course = (unsigned char)course;
+    fillCount++;
+    if (fillCount == AUDIT_BATCH_SIZE) {
+        submitBatch();
+    }
+}
+
+void AuditLog::sealPending() {
+    if (fillBatch >= 0 && fillCount > 0) {
+        submitBatch();
+    }
+}
+
+// Seal everything and wait until it has reached the file
+void AuditLog::flush() {
+    if (handle < 0) {
+        return;
+    }
+    sealPending();
+    {
+        unique_lock<mutex> guard(lock);
+        while (queueCount > 0 || sealing) {
+            changed.wait(guard);
+        }
+    }
+    writer->flush(handle);
+    writer->waitFile(handle);
+}
+
+// Sealing thread: hash queued batches and append them as blocks
+void AuditLog::runSealer() {
+    while (true) {
+        int batch;
+        int count;
+        {
+            unique_lock<mutex> guard(lock);
+            while (queueCount == 0 && !stopping) {
+                changed.wait(guard);
+            }
+            if (queueCount == 0) {
+                return;
+            }
+            batch = queue[queueHead];
+            count = queueCounts[queueHead];
+            queueHead = (queueHead + 1) % AUDIT_QUEUE_BATCHES;
+            queueCount--;
+            sealing = true;
+        }
+
+        sealBatch(batchMemory + batch * AUDIT_BATCH_SIZE, count);
+
+        bool idle;
+        {
+            lock_guard<mutex> guard(lock);
+            freeBatches[freeCount++] = batch;
+            sealing = false;
+            idle = queueCount == 0;
+        }
+        // Nothing else to seal: pass the written blocks on to the file
+        if (idle) {
+            writer->flush(handle);
+        }
+        changed.notify_all();
+    }
+}
+
+// Hash one batch into a block and append it
+void AuditLog::sealBatch(const AuditEntry* entries, int count) {
+    AuditBlockInfo b;
+    b.count = count;
+    b.firstSequence = entries[0].sequence;
+    memcpy(b.prevHash, lastHash, SHA256_BYTES);
+    merkleRoot(entries, count, b.root);
+    blockHashOf(b, b.hash);
+
+    char header[AUDIT_BLOCK_HEADER_BYTES];
+    encodeBlockHeader(b, header);
+    writer->write(handle, header, AUDIT_BLOCK_HEADER_BYTES);
+    writer->write(handle, (const char*)entries, count * sizeof(AuditEntry));
+
+    memcpy(lastHash, b.hash, SHA256_BYTES);
+    blockCount++;
+    entriesWritten += count;
+}
+
+long long AuditLog::getBlockCount() const {
+    return blockCount.load();
+}
+
+long long AuditLog::getEntriesWritten() const {
+    return entriesWritten.load();
+}
+
+// Recompute the Merkle roots of blocks [begin, end), bad = first mismatch or -1
+static void checkBlockRoots(string fileName, const AuditBlockInfo* blocks,
+                            long long begin, long long end, long long* bad) {
+    *bad = -1;
+    ifstream file(fileName.c_str(), ios::binary);
+    AuditEntry* entries = new AuditEntry[AUDIT_BATCH_SIZE];
+    for (long long i = begin; i < end; i++) {
+        file.seekg(blocks[i].offset + AUDIT_BLOCK_HEADER_BYTES);
+        file.read((char*)entries, blocks[i].count * sizeof(AuditEntry));
+        unsigned char root[SHA256_BYTES];
+        if (file) {
+            merkleRoot(entries, blocks[i].count, root);
+        }
+        if (!file || memcmp(root, blocks[i].root, SHA256_BYTES) != 0) {
+            *bad = i;
+            break;
+        }
+    }
+    delete[] entries;
+}
+
+// Check a log file
+bool verifyAuditLog(const string& fileName, bool incremental, int threadCount,
+                    AuditVerifyResult& result) {
+    result.blocks = 0;
+    result.entries = 0;
+    result.blocksRehashed = 0;
+    result.firstBadBlock = -1;
+    result.problem = "";
+
+    AuditBlockInfo* blocks;
+    long long n;
+    bool hasHeader;
+    if (!readBlockInfos(fileName, blocks, n, hasHeader, result.problem)) {
+        result.firstBadBlock = n;
+        result.blocks = n;
+        delete[] blocks;
+        return false;
+    }
+    if (!hasHeader) {
+        result.problem = "cannot open audit log file";
+        return false;
+    }
+    result.blocks = n;
+
+    // Hash chain over the headers (one digest per block)
+    unsigned char previous[SHA256_BYTES];
+    memset(previous, 0, SHA256_BYTES);
+    unsigned long long expectedSequence = 0;
+    for (long long i = 0; i < n; i++) {
+        unsigned char hash[SHA256_BYTES];
+        blockHashOf(blocks[i], hash);
+        if (memcmp(blocks[i].prevHash, previous, SHA256_BYTES) != 0
+            || memcmp(blocks[i].hash, hash, SHA256_BYTES) != 0) {
+            result.firstBadBlock = i;
+            result.problem = "hash chain broken";
+            delete[] blocks;
+            return false;
+        }
+        if (blocks[i].firstSequence != expectedSequence) {
+            result.firstBadBlock = i;
+            result.problem = "entry sequence numbers do not follow on";
+            delete[] blocks;
+            return false;
+        }
+        memcpy(previous, hash, SHA256_BYTES);
+        expectedSequence += blocks[i].count;
+        result.entries += blocks[i].count;
+    }
+
+    // Blocks already checked, if the chain still passes through the checkpoint
+    string checkpointName = fileName + ".verified";
+    long long start = 0;
+    if (incremental) {
+        ifstream checkpoint(checkpointName.c_str(), ios::binary);
+        char raw[4 + 8 + SHA256_BYTES];
+        long long verifiedBlocks = 0;
+        if (checkpoint.read(raw, sizeof(raw)) && memcmp(raw, CHECKPOINT_MAGIC, 4) == 0) {
+            memcpy(&verifiedBlocks, raw + 4, 8);
+            if (verifiedBlocks > 0 && verifiedBlocks <= n
+                && memcmp(blocks[verifiedBlocks - 1].hash, raw + 12, SHA256_BYTES) == 0) {
+                start = verifiedBlocks;
+            }
+        }
+    }
+
+    // Merkle roots of the remaining blocks on parallel threads
+    long long todo = n - start;
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+    if (todo < threadCount) {
+        threadCount = todo > 1 ? (int)todo : 1;
+    }
+    long long* bad = new long long[threadCount];
+    thread* workers = new thread[threadCount];
+    long long chunk = (todo + threadCount - 1) / threadCount;
+    for (int t = 0; t < threadCount; t++) {
+        long long begin = start + (t * chunk < todo ? t * chunk : todo);
+        long long end = begin + chunk < n ? begin + chunk : n;
+        if (t == threadCount - 1) {
+            checkBlockRoots(fileName, blocks, begin, end, &bad[t]);
+        } else {
+            workers[t] = thread(checkBlockRoots, fileName, blocks, begin, end, &bad[t]);
+        }
+    }
+    for (int t = 0; t < threadCount - 1; t++) {
+        workers[t].join();
+    }
+    delete[] workers;
+    result.blocksRehashed = todo;
+    for (int t = 0; t < threadCount; t++) {
+        if (bad[t] >= 0) {
+            result.firstBadBlock = bad[t];
+            result.problem = "entries do not match the block's Merkle root";
+            break;
+        }
+    }
+    delete[] bad;
+
+    // Move the checkpoint forward
+    if (result.firstBadBlock < 0 && n > 0) {
+        ofstream checkpoint(checkpointName.c_str(), ios::binary | ios::trunc);
+        checkpoint.write(CHECKPOINT_MAGIC, 4);
+        checkpoint.write((const char*)&n, 8);
+        checkpoint.write((const char*)blocks[n - 1].hash, SHA256_BYTES);
+    }
+    delete[] blocks;
+    return result.firstBadBlock < 0;
+}
+
+// Read the last entries of a log file (oldest first)
+int readRecentAuditEntries(const string& fileName, AuditEntry* out, int maxEntries) {
+    AuditBlockInfo* blocks;
+    long long n;
+    bool hasHeader;
+    string problem;
+    if (!readBlockInfos(fileName, blocks, n, hasHeader, problem)) {
+        delete[] blocks;
+        return 0;
+    }
+    // Blocks that hold the last maxEntries entries
+    long long first = n;
+    long long skip = maxEntries;
+    while (first > 0 && skip > 0) {
+        first--;
+        skip -= blocks[first].count;
+    }
+    skip = skip < 0 ? -skip : 0;
+
+    ifstream file(fileName.c_str(), ios::binary);
+    AuditEntry* entries = new AuditEntry[AUDIT_BATCH_SIZE];
+    int got = 0;
+    for (long long i = first; i < n && file; i++) {
+        file.seekg(blocks[i].offset + AUDIT_BLOCK_HEADER_BYTES);
+        file.read((char*)entries, blocks[i].count * sizeof(AuditEntry));
+        for (int k = 0; k < blocks[i].count && file; k++) {
+            if (skip > 0) {
+                skip--;
+                continue;
+            }
+            out[got++] = entries[k];
+        }
+    }
+    delete[] entries;
+    delete[] blocks;
+    return got;
+}
+
+// Local time of an entry as "YYYY-MM-DD HH:MM:SS"
+string formatAuditTime(long long timeMicros) {
+    time_t seconds = (time_t)(timeMicros / 1000000);
+    tm local;
+#ifdef _WIN32
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    char text[32];
+    strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &local);
+    return text;
+}
+
+static AuditLog* activeAudit = nullptr;
+static thread_local int auditMuteDepth = 0;
+
+void setAuditLog(AuditLog* log) {
+    activeAudit = log;
+}
+
+// Record a score change made on the caller's thread, unless muted
+void recordScoreChange(const string& id, int course, double oldScore, double newScore) {
+    if (activeAudit == nullptr || auditMuteDepth > 0) {
+        return;
+    }
+    activeAudit->record(packStudentId(id), course, oldScore, newScore);
+}
+
+AuditMute::AuditMute() {
+    auditMuteDepth++;
+}
+
+AuditMute::~AuditMute() {
+    auditMuteDepth--;
+}
@@ -0,0 +1,145 @@
+// AuditLog.h - Tamper-evident audit trail of grade changes
+#ifndef AUDITLOG_H
+#define AUDITLOG_H
+
+#include "AsyncWriter.h"
+#include "Sha256.h"
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+using namespace std;
+
+// Entries hashed into one Merkle block
+const int AUDIT_BATCH_SIZE = 256;
+
+// Batches that can wait for the sealing thread
+const int AUDIT_QUEUE_BATCHES = 8;
+
+// Characters kept of the operator name
+const int AUDIT_OPERATOR_CHARS = 15;
+
+// One grade change (56 bytes on disk)
+struct AuditEntry {
+    unsigned long long sequence;     // 0, 1, 2, ... over the whole log
+    long long timeMicros;            // microseconds since 1970-01-01 UTC
+    unsigned long long studentId;    // packed student ID
+    double oldScore;
+    double newScore;
+    char operatorName[AUDIT_OPERATOR_CHARS];   // padded with '\0'
+    unsigned char course;            // course index in the student
+};
+
+// Outcome of verifying a log file
+struct AuditVerifyResult {
+    long long blocks;                // blocks in the file
+    long long entries;               // entries in the file
+    long long blocksRehashed;        // blocks whose Merkle root was recomputed
+    long long firstBadBlock;         // -1 if the log is intact
+    string problem;                  // description of the first problem
+};
+
+// Append-only log. Changes are copied into a batch on the caller's thread;
+// full batches are sealed on a background thread: every entry is hashed as
+// a Merkle leaf, the block hash covers the previous block hash and the
+// Merkle root, and the block is appended through the AsyncWriter.
+class AuditLog {
+private:
+    AsyncWriter* writer;
+    int handle;                      // -1 while closed
+    string fileName;
+    char operatorName[AUDIT_OPERATOR_CHARS];
+
+    // Batches: the caller fills one, the sealing thread works on queued ones
+    AuditEntry* batchMemory;         // AUDIT_QUEUE_BATCHES * AUDIT_BATCH_SIZE
+    int fillBatch;                   // batch being filled, -1 if none
+    int fillCount;
+    unsigned long long nextSequence;
+    int freeBatches[AUDIT_QUEUE_BATCHES];
+    int freeCount;
+    int queue[AUDIT_QUEUE_BATCHES];
+    int queueCounts[AUDIT_QUEUE_BATCHES];
+    int queueHead;
+    int queueCount;
+    bool sealing;                    // sealing thread is busy with a batch
+    bool stopping;
+    mutex lock;
+    condition_variable changed;
+    thread sealer;
+
+    // Chain state (sealing thread)
+    unsigned char lastHash[SHA256_BYTES];
+    atomic<long long> blockCount;
+    atomic<long long> entriesWritten;
+
+    // Not copyable
+    AuditLog(const AuditLog& other);
+    AuditLog& operator=(const AuditLog& other);
+
+    int takeFreeBatch();
+    void submitBatch();
+    void runSealer();
+    void sealBatch(const AuditEntry* entries, int count);
+
+public:
+    AuditLog();
+    ~AuditLog();
+
+    // Open (or continue) a log file. An existing log is checked for a
+    // complete last block and its chain continues. Waits for the file to be
+    // opened; false if it is damaged or cannot be opened.
+    bool open(AsyncWriter& w, const string& name, const string& operatorName);
+
+    // Seal the partial batch, wait for the sealing thread, close the file
+    void close();
+
+    bool isOpen() const;
+    string getFileName() const;
+
+    // Record one grade change (the hot path: copies into the current batch)
+    void record(unsigned long long studentId, int course, double oldScore, double newScore);
+
+    // Hand the partial batch to the sealing thread
+    void sealPending();
+
+    // Seal everything and wait until it has reached the file
+    void flush();
+
+    long long getBlockCount() const;
+    long long getEntriesWritten() const;
+};
+
+// Check a log file: the hash chain over all block headers, then the Merkle
+// root of every block on parallel threads. Incremental mode trusts the
+// blocks covered by the checkpoint file (fileName + ".verified") when the
+// chain still passes through the checkpoint hash, and rehashes only newer
+// blocks. The checkpoint is not authenticated: anyone who can rewrite the
+// log can rewrite it too, so only a full check is a tamper check.
+// Incremental mode finds damage in blocks written since the last check.
+// A successful check moves the checkpoint forward.
+bool verifyAuditLog(const string& fileName, bool incremental, int threadCount,
+                    AuditVerifyResult& result);
+
+// Read the last entries of a log file (oldest first), returns the count
+int readRecentAuditEntries(const string& fileName, AuditEntry* out, int maxEntries);
+
+// Local time of an entry as "YYYY-MM-DD HH:MM:SS"
+string formatAuditTime(long long timeMicros);
+
+// Global hook used by Student::setScore (does nothing without a log or
+// while an AuditMute exists in this thread)
+void setAuditLog(AuditLog* log);
+void recordScoreChange(const string& id, int course, double oldScore, double newScore);
+
+// Keep score changes of this thread out of the audit log while the object
+// exists (temporary Student objects, synthetic workloads). Separate from
+// ChangeFeedMute, so muting notifications never drops audit entries.
+class AuditMute {
+public:
+    AuditMute();
+    ~AuditMute();
+};
+
+#endif // AUDITLOG_H
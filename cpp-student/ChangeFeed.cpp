@@ -0,0 +1,266 @@
+// ChangeFeed.cpp - Change notifications for roster mutations
+#include "ChangeFeed.h"
+#include <cstring>
+#include <thread>
+#include <chrono>
+
+static ChangeFeed* activeFeed = nullptr;
+static thread_local int muteDepth = 0;
+
+// Constructor
+ChangeFeed::ChangeFeed(int minCapacity, BackpressurePolicy p) {
+    capacity = 1;
+    while (capacity < (unsigned long long)minCapacity) {
+        capacity *= 2;
+    }
+    mask = capacity - 1;
+    slots = new Slot[capacity];
+    for (unsigned long long i = 0; i < capacity; i++) {
+        slots[i].stamp.store(0, memory_order_relaxed);
+    }
+    head.store(0, memory_order_relaxed);
+    policy = p;
+    subscriberCount = 0;
+    dropped = 0;
+}
+
+// Destructor
+ChangeFeed::~ChangeFeed() {
+    for (int i = 0; i < subscriberCount; i++) {
+        subscribers[i]->feed = nullptr;
+    }
+    if (activeFeed == this) {
+        activeFeed = nullptr;
+    }
+    delete[] slots;
+}
+
+// Cursor of the subscriber furthest behind
+unsigned long long ChangeFeed::slowestCursor() const {
+    unsigned long long slowest = head.load(memory_order_relaxed);
+    for (int i = 0; i < subscriberCount; i++) {
+        unsigned long long c = subscribers[i]->cursor.load(memory_order_acquire);
+        if (c < slowest) slowest = c;
+    }
+    return slowest;
+}
+
+// Publish an event (producer thread only)
+bool ChangeFeed::publish(ChangeEvent& event) {
+    unsigned long long n = head.load(memory_order_relaxed);
+
+    if (policy != OVERWRITE_OLDEST && subscriberCount > 0) {
+        chrono::steady_clock::time_point deadline;
+        bool waiting = false;
+        while (n - slowestCursor() >= capacity) {
+            if (policy == DROP_NEWEST) {
+                dropped++;
+                return false;
+            }
+            // BLOCK_PRODUCER: wait for subscribers, but not forever
+            if (!waiting) {
+                deadline = chrono::steady_clock::now() + chrono::milliseconds(BLOCK_PRODUCER_MAX_WAIT_MS);
+                waiting = true;
+            } else if (chrono::steady_clock::now() >= deadline) {
+                dropped++;
+                return false;
+            }
+            this_thread::yield();
+        }
+    }
+
+    event.sequence = n;
+    Slot& slot = slots[n & mask];
+    slot.stamp.store(2 * n + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot.event = event;
+    slot.stamp.store(2 * n + 2, memory_order_release);
+    head.store(n + 1, memory_order_release);
+    return true;
+}
+
+unsigned long long ChangeFeed::getHead() const {
+    return head.load(memory_order_acquire);
+}
+
+unsigned long long ChangeFeed::getCapacity() const {
+    return capacity;
+}
+
+unsigned long long ChangeFeed::getDropped() const {
+    return dropped;
+}
+
+BackpressurePolicy ChangeFeed::getPolicy() const {
+    return policy;
+}
+
+// Constructor - register with the feed, start at its current end
+ChangeSubscriber::ChangeSubscriber(ChangeFeed* f) {
+    feed = f;
+    lost = 0;
+    cursor.store(f->getHead(), memory_order_relaxed);
+    if (f->subscriberCount < MAX_SUBSCRIBERS) {
+        f->subscribers[f->subscriberCount++] = this;
+    } else {
+        // Feed is full: stay detached so poll() returns nothing
+        feed = nullptr;
+    }
+}
+
+bool ChangeSubscriber::isRegistered() const {
+    return feed != nullptr;
+}
+
+// Destructor - unregister from the feed
+ChangeSubscriber::~ChangeSubscriber() {
+    if (feed == nullptr) {
+        return;
+    }
+    for (int i = 0; i < feed->subscriberCount; i++) {
+        if (feed->subscribers[i] == this) {
+            feed->subscribers[i] = feed->subscribers[feed->subscriberCount - 1];
+            feed->subscriberCount--;
+            break;
+        }
+    }
+}
+
+// Check if a new event changes the same field as an earlier one
+static bool sameField(const ChangeEvent& earlier, const ChangeEvent& e) {
+    if (earlier.type != e.type) {
+        return false;
+    }
+    switch (e.type) {
+        case CHANGE_SCORE:
+            return earlier.studentId == e.studentId && earlier.course == e.course;
+        case CHANGE_NAME:
+            return earlier.studentId == e.studentId;
+        case CHANGE_ID:
+            return earlier.studentId == e.oldId;
+    }
+    return false;
+}
+
+// Read up to maxEvents new events
+int ChangeSubscriber::poll(ChangeEvent* out, int maxEvents, bool coalesce) {
+    if (feed == nullptr) {
+        return 0;
+    }
+    unsigned long long h = feed->head.load(memory_order_acquire);
+    unsigned long long c = cursor.load(memory_order_relaxed);
+    if (h - c > feed->capacity) {
+        lost += h - c - feed->capacity;
+        c = h - feed->capacity;
+    }
+
+    int count = 0;
+    // The last event in out[] was the previous event of the feed (no lost
+    // events in between), so the next one may be merged into it
+    bool adjacent = false;
+    while (c < h && count < maxEvents) {
+        ChangeFeed::Slot& slot = feed->slots[c & feed->mask];
+        unsigned long long before = slot.stamp.load(memory_order_acquire);
+        ChangeEvent e = slot.event;
+        atomic_thread_fence(memory_order_acquire);
+        unsigned long long after = slot.stamp.load(memory_order_relaxed);
+        c++;
+        if (before != 2 * c || after != before) {
+            // Overwritten by the producer while we were behind
+            lost++;
+            adjacent = false;
+            continue;
+        }
+
+        // Only back-to-back changes of one field are merged, so a change
+        // never moves across a remove, add or other event in between
+        if (coalesce && adjacent && sameField(out[count - 1], e)) {
+            // Keep the first old value, take the latest new value
+            ChangeEvent& last = out[count - 1];
+            last.sequence = e.sequence;
+            last.studentId = e.studentId;
+            last.newScore = e.newScore;
+            memcpy(last.newName, e.newName, sizeof(e.newName));
+        } else {
+            out[count++] = e;
+        }
+        adjacent = true;
+    }
+    cursor.store(c, memory_order_release);
+    return count;
+}
+
+unsigned long long ChangeSubscriber::pending() const {
+    if (feed == nullptr) {
+        return 0;
+    }
+    return feed->getHead() - cursor.load(memory_order_relaxed);
+}
+
+unsigned long long ChangeSubscriber::getLost() const {
+    return lost;
+}
+
+// Feed used by the Student setters
+void setChangeFeed(ChangeFeed* feed) {
+    activeFeed = feed;
+}
+
+// Copy a name into a fixed-size field
+static void copyName(char* dest, const string& n) {
+    memset(dest, 0, 9);
+    memcpy(dest, n.data(), n.length() < 8 ? n.length() : 8);
+}
+
+// Start an event, returns false if notifications are off
+static bool beginEvent(ChangeEvent& e, int type) {
+    if (activeFeed == nullptr || muteDepth > 0) {
+        return false;
+    }
+    memset(&e, 0, sizeof(e));
+    e.type = type;
+    return true;
+}
+
+void publishIdChange(const string& oldId, const string& newId) {
+    ChangeEvent e;
+    if (!beginEvent(e, CHANGE_ID)) return;
+    e.oldId = packStudentId(oldId);
+    e.studentId = packStudentId(newId);
+    activeFeed->publish(e);
+}
+
+void publishNameChange(const string& id, const string& oldName, const string& newName) {
+    ChangeEvent e;
+    if (!beginEvent(e, CHANGE_NAME)) return;
+    e.studentId = packStudentId(id);
+    copyName(e.oldName, oldName);
+    copyName(e.newName, newName);
+    activeFeed->publish(e);
+}
+
+void publishScoreChange(const string& id, int course, double oldScore, double newScore) {
+    ChangeEvent e;
+    if (!beginEvent(e, CHANGE_SCORE)) return;
+    e.studentId = packStudentId(id);
+    e.course = course;
+    e.oldScore = oldScore;
+    e.newScore = newScore;
+    activeFeed->publish(e);
+}
+
+void publishStudentChange(int type, const Student& s) {
+    ChangeEvent e;
+    if (!beginEvent(e, type)) return;
+    e.studentId = packStudentId(s.getStudentId());
+    copyName(e.newName, s.getName());
+    activeFeed->publish(e);
+}
+
+ChangeFeedMute::ChangeFeedMute() {
+    muteDepth++;
+}
+
+ChangeFeedMute::~ChangeFeedMute() {
+    muteDepth--;
+}
@@ -0,0 +1,140 @@
+// ChangeFeed.h - Change notifications for roster mutations
+#ifndef CHANGEFEED_H
+#define CHANGEFEED_H
+
+#include "Student.h"
+#include <atomic>
+
+// Kind of change
+enum ChangeType {
+    CHANGE_ADD = 1,      // student added to the roster
+    CHANGE_REMOVE,       // student removed from the roster
+    CHANGE_ID,           // student ID changed
+    CHANGE_NAME,         // name changed
+    CHANGE_SCORE         // one course score changed
+};
+
+// What the producer does when the slowest subscriber is a full ring behind
+enum BackpressurePolicy {
+    OVERWRITE_OLDEST,    // never wait, slow subscribers lose old events
+    DROP_NEWEST,         // reject the new event
+    BLOCK_PRODUCER       // wait until the slowest subscriber catches up,
+                         // at most BLOCK_PRODUCER_MAX_WAIT_MS (then dropped)
+};
+
+// Longest wait of a BLOCK_PRODUCER publish. A subscriber polled from the
+// producer's own thread can never catch up while the producer waits, so
+// the wait is bounded instead of spinning forever.
+const int BLOCK_PRODUCER_MAX_WAIT_MS = 100;
+
+// One change (fixed size so it can be copied into a ring slot)
+struct ChangeEvent {
+    unsigned long long sequence;     // position in the feed
+    int type;                        // ChangeType
+    int course;                      // course index (CHANGE_SCORE)
+    unsigned long long studentId;    // packed ID after the change
+    unsigned long long oldId;        // packed ID before the change (CHANGE_ID)
+    char oldName[9];                 // CHANGE_NAME
+    char newName[9];                 // CHANGE_NAME, CHANGE_ADD, CHANGE_REMOVE
+    double oldScore;                 // CHANGE_SCORE
+    double newScore;                 // CHANGE_SCORE
+};
+
+const int MAX_SUBSCRIBERS = 16;
+
+class ChangeSubscriber;
+
+// Single-producer / multi-consumer ring buffer of change events.
+// Each slot carries a stamp (odd while being written, 2 * sequence + 2 when
+// complete), so subscribers read without locks and detect overwritten slots.
+class ChangeFeed {
+private:
+    struct Slot {
+        atomic<unsigned long long> stamp;
+        ChangeEvent event;
+    };
+
+    Slot* slots;
+    unsigned long long capacity;     // power of two
+    unsigned long long mask;
+    atomic<unsigned long long> head; // sequence of the next event
+    BackpressurePolicy policy;
+    ChangeSubscriber* subscribers[MAX_SUBSCRIBERS];
+    int subscriberCount;
+    unsigned long long dropped;
+
+    // Not copyable
+    ChangeFeed(const ChangeFeed& other);
+    ChangeFeed& operator=(const ChangeFeed& other);
+
+    unsigned long long slowestCursor() const;
+
+    friend class ChangeSubscriber;
+
+public:
+    // Capacity is rounded up to a power of two
+    ChangeFeed(int minCapacity, BackpressurePolicy p);
+    ~ChangeFeed();
+
+    // Publish an event (producer thread only), false if dropped
+    bool publish(ChangeEvent& event);
+
+    unsigned long long getHead() const;
+    unsigned long long getCapacity() const;
+    unsigned long long getDropped() const;
+    BackpressurePolicy getPolicy() const;
+};
+
+// Reader of a change feed with its own cursor.
+// Create subscribers before other threads start using the feed.
+class ChangeSubscriber {
+private:
+    ChangeFeed* feed;
+    atomic<unsigned long long> cursor;
+    unsigned long long lost;
+
+    // Not copyable
+    ChangeSubscriber(const ChangeSubscriber& other);
+    ChangeSubscriber& operator=(const ChangeSubscriber& other);
+
+    friend class ChangeFeed;
+
+public:
+    // Starts at the current end of the feed. A feed takes at most
+    // MAX_SUBSCRIBERS; check isRegistered() after construction.
+    ChangeSubscriber(ChangeFeed* f);
+    ~ChangeSubscriber();
+
+    // Read up to maxEvents new events. With coalesce, back-to-back changes of
+    // the same field become one event with the first old value and the last
+    // new value; changes separated by any other event are kept apart.
+    int poll(ChangeEvent* out, int maxEvents, bool coalesce);
+
+    // False if the feed already had MAX_SUBSCRIBERS (poll() returns nothing)
+    bool isRegistered() const;
+
+    // Events published but not read yet
+    unsigned long long pending() const;
+
+    // Events overwritten before this subscriber read them
+    unsigned long long getLost() const;
+};
+
+// Feed used by the Student setters (nullptr = no notifications)
+void setChangeFeed(ChangeFeed* feed);
+
+// Publish helpers, do nothing without a feed or while muted
+void publishIdChange(const string& oldId, const string& newId);
+void publishNameChange(const string& id, const string& oldName, const string& newName);
+void publishScoreChange(const string& id, int course, double oldScore, double newScore);
+void publishStudentChange(int type, const Student& s);
+
+// Suppress notifications in this thread while the object exists
+// (used when filling temporary Student objects, e.g. while decoding files)
+class ChangeFeedMute {
+public:
+    ChangeFeedMute();
+    ~ChangeFeedMute();
+};
+
+#endif // CHANGEFEED_H
@@ -0,0 +1,225 @@
+// CompactRoster.cpp - Compact fixed-point student storage
+#include "CompactRoster.h"
+#include "ChangeFeed.h"
+#include "AuditLog.h"
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <sstream>
+
+static_assert(sizeof(CompactStudent) <= 32, "CompactStudent must stay under 32 bytes");
+
+// Convert a student, false if a score was rounded to hundredths
+bool toCompact(const Student& s, CompactStudent& c) {
+    memset(&c, 0, sizeof(c));
+    unsigned long long id = packStudentId(s.getStudentId());
+    c.idLow = (unsigned int)id;
+    c.idHigh = (unsigned char)(id >> 32);
+    string n = s.getName();
+    memcpy(c.name, n.data(), n.length() < 8 ? n.length() : 8);
+    c.age = (unsigned char)s.getAge();
+    int courseCount = s.getCourseCount();
+    c.flags = (unsigned char)((courseCount << COMPACT_COURSE_SHIFT)
+                              | (s.getGender() == 'F' ? COMPACT_FEMALE : 0));
+
+    bool exact = true;
+    for (int i = 0; i < courseCount && i < 5; i++) {
+        double scaled = s.getScore(i) * COMPACT_SCORE_SCALE;
+        double rounded = floor(scaled + 0.5);
+        c.scores[i] = (unsigned short)rounded;
+        if (rounded / COMPACT_SCORE_SCALE != s.getScore(i)) {
+            exact = false;
+        }
+    }
+    return exact;
+}
+
+// Convert back to a Student (no change notifications or audit records)
+void fromCompact(const CompactStudent& c, Student& s) {
+    // Rebuilt from compact storage, not a roster change
+    ChangeFeedMute mute;
+    AuditMute auditMute;
+    int courseCount = compactCourseCount(c);
+    s = Student(unpackStudentId(compactId(c)), compactName(c), c.age,
+                compactGender(c), courseCount);
+    for (int i = 0; i < courseCount; i++) {
+        s.setScore(i, compactScore(c, i));
+    }
+    s.calcAverage();
+}
+
+unsigned long long compactId(const CompactStudent& c) {
+    return ((unsigned long long)c.idHigh << 32) | c.idLow;
+}
+
+string compactName(const CompactStudent& c) {
+    int nameLength = 0;
+    while (nameLength < 8 && c.name[nameLength] != '\0') {
+        nameLength++;
+    }
+    return string(c.name, nameLength);
+}
+
+char compactGender(const CompactStudent& c) {
+    return (c.flags & COMPACT_FEMALE) ? 'F' : 'M';
+}
+
+int compactCourseCount(const CompactStudent& c) {
+    return (c.flags >> COMPACT_COURSE_SHIFT) & 7;
+}
+
+double compactScore(const CompactStudent& c, int index) {
+    return (double)c.scores[index] / COMPACT_SCORE_SCALE;
+}
+
+// Average computed from the integer scores with a single rounding
+double compactAverage(const CompactStudent& c) {
+    int courseCount = compactCourseCount(c);
+    if (courseCount == 0) {
+        return 0.0;
+    }
+    int sum = 0;
+    for (int i = 0; i < courseCount; i++) {
+        sum += c.scores[i];
+    }
+    return (double)sum / (courseCount * COMPACT_SCORE_SCALE);
+}
+
+// Check if any course score < 60
+bool compactHasFailedCourse(const CompactStudent& c) {
+    int courseCount = compactCourseCount(c);
+    for (int i = 0; i < courseCount; i++) {
+        if (c.scores[i] < 60 * COMPACT_SCORE_SCALE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Display full information, same layout as Student::display()
+void displayCompact(const CompactStudent& c, ostream& out) {
+    int courseCount = compactCourseCount(c);
+    out << "========================================" << endl;
+    out << "Student ID    : " << unpackStudentId(compactId(c)) << endl;
+    out << "Name          : " << compactName(c) << endl;
+    out << "Age           : " << (int)c.age << endl;
+    out << "Gender        : " << (compactGender(c) == 'M' ? "Male" : "Female") << endl;
+    out << "Course Count  : " << courseCount << endl;
+    out << "Scores        : ";
+    for (int i = 0; i < courseCount; i++) {
+        out << "Course" << (i + 1) << ":" << compactScore(c, i);
+        if (i < courseCount - 1) out << ", ";
+    }
+    out << endl;
+    out << "Average Score : " << compactAverage(c) << endl;
+    out << "Failed Course : " << (compactHasFailedCourse(c) ? "Yes" : "No") << endl;
+    out << "========================================" << endl;
+}
+
+// Display brief information, same layout as Student::displayBrief()
+void displayCompactBrief(const CompactStudent& c, ostream& out) {
+    out << unpackStudentId(compactId(c)) << "\t" << compactName(c) << "\t"
+        << compactGender(c) << "\t" << compactAverage(c) << endl;
+}
+
+// Orders roster positions by packed student ID
+struct CompactIdLess {
+    const CompactStudent* list;
+    bool operator()(int a, int b) const {
+        return compactId(list[a]) < compactId(list[b]);
+    }
+};
+
+// Constructor
+CompactRoster::CompactRoster() {
+    list = nullptr;
+    byId = nullptr;
+    count = 0;
+    roundedStudents = 0;
+}
+
+// Destructor
+CompactRoster::~CompactRoster() {
+    clear();
+}
+
+// Convert every student of a roster array
+void CompactRoster::build(const Student* const* students, int n) {
+    clear();
+    list = new CompactStudent[n > 0 ? n : 1];
+    for (int i = 0; i < n; i++) {
+        if (!toCompact(*students[i], list[i])) {
+            roundedStudents++;
+        }
+    }
+    count = n;
+
+    byId = new int[n > 0 ? n : 1];
+    for (int i = 0; i < n; i++) {
+        byId[i] = i;
+    }
+    CompactIdLess less;
+    less.list = list;
+    sort(byId, byId + n, less);
+}
+
+void CompactRoster::clear() {
+    delete[] list;
+    delete[] byId;
+    list = nullptr;
+    byId = nullptr;
+    count = 0;
+    roundedStudents = 0;
+}
+
+int CompactRoster::size() const {
+    return count;
+}
+
+const CompactStudent& CompactRoster::at(int index) const {
+    return list[index];
+}
+
+// Students whose display() output differs from displayCompact()
+int CompactRoster::displayDifferences(const Student* const* students) const {
+    int differences = 0;
+    for (int i = 0; i < count; i++) {
+        ostringstream full;
+        ostringstream compact;
+        students[i]->display(full);
+        students[i]->displayBrief(full);
+        displayCompact(list[i], compact);
+        displayCompactBrief(list[i], compact);
+        if (full.str() != compact.str()) {
+            differences++;
+        }
+    }
+    return differences;
+}
+
+// Position of a student ID, -1 if not found (binary search on byId)
+int CompactRoster::findById(unsigned long long packedId) const {
+    int low = 0;
+    int high = count - 1;
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+        unsigned long long midId = compactId(list[byId[mid]]);
+        if (midId == packedId) {
+            return byId[mid];
+        }
+        if (midId < packedId) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return -1;
+}
+
+long long CompactRoster::getRoundedStudents() const {
+    return roundedStudents;
+}
+
+long long CompactRoster::memoryBytes() const {
+    return (long long)count * (sizeof(CompactStudent) + sizeof(int));
+}
@@ -0,0 +1,86 @@
+// CompactRoster.h - Compact fixed-point student storage
+#ifndef COMPACTROSTER_H
+#define COMPACTROSTER_H
+
+#include "Student.h"
+
+// Scores are stored in hundredths of a point (0..10000 fits in 16 bits).
+// Tenths would also fit, but the score prompts accept values such as 85.25
+// that tenths cannot hold.
+const int COMPACT_SCORE_SCALE = 100;
+
+// Flag bits
+const unsigned char COMPACT_FEMALE = 0x01;
+const int COMPACT_COURSE_SHIFT = 1;          // course count in bits 1..3
+
+// One student in 28 bytes: no heap allocations, the average is computed
+// from the scores when needed
+struct CompactStudent {
+    unsigned int idLow;          // low 32 bits of the packed ID
+    unsigned short scores[5];    // hundredths of a point
+    char name[8];                // padded with '\0'
+    unsigned char idHigh;        // bits 32..39 of the packed ID
+    unsigned char age;
+    unsigned char flags;         // gender and course count
+};
+
+// Convert a student, false if a score was rounded to hundredths
+bool toCompact(const Student& s, CompactStudent& c);
+
+// Convert back to a Student (no change notifications or audit records)
+void fromCompact(const CompactStudent& c, Student& s);
+
+// Fields of a compact student
+unsigned long long compactId(const CompactStudent& c);
+string compactName(const CompactStudent& c);
+char compactGender(const CompactStudent& c);
+int compactCourseCount(const CompactStudent& c);
+double compactScore(const CompactStudent& c, int index);
+
+// Average computed from the integer scores with a single rounding
+double compactAverage(const CompactStudent& c);
+
+// Check if any course score < 60
+bool compactHasFailedCourse(const CompactStudent& c);
+
+// Display in the same layout as Student::display() / displayBrief()
+void displayCompact(const CompactStudent& c, ostream& out = cout);
+void displayCompactBrief(const CompactStudent& c, ostream& out = cout);
+
+// Students stored as CompactStudent records, in roster order, with an
+// index of positions sorted by ID for lookups (4 bytes per student)
+class CompactRoster {
+private:
+    CompactStudent* list;
+    int* byId;                   // positions sorted by packed ID
+    int count;
+    long long roundedStudents;   // students with a score rounded to hundredths
+
+    // Not copyable
+    CompactRoster(const CompactRoster& other);
+    CompactRoster& operator=(const CompactRoster& other);
+
+public:
+    CompactRoster();
+    ~CompactRoster();
+
+    // Convert every student of a roster array
+    void build(const Student* const* students, int n);
+    void clear();
+
+    // Students of the array passed to build() whose display() output
+    // differs from displayCompact() (scores finer than 0.01, or an average
+    // that prints differently)
+    int displayDifferences(const Student* const* students) const;
+
+    int size() const;
+    const CompactStudent& at(int index) const;
+
+    // Position of a student ID, -1 if not found
+    int findById(unsigned long long packedId) const;
+
+    long long getRoundedStudents() const;
+    long long memoryBytes() const;
+};
+
+#endif // COMPACTROSTER_H
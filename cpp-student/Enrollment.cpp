@@ -0,0 +1,466 @@
+// Enrollment.cpp - Course catalog and sparse enrollment/score matrix
+#include "Enrollment.h"
+#include "Validate.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+// Hash key of a course ID (negative IDs map to large keys, not to the
+// empty-cell marker of IdHash)
+static unsigned long long courseKey(int courseId) {
+    return (unsigned int)courseId;
+}
+
+// Constructor
+CourseCatalog::CourseCatalog() {
+    capacity = 8;
+    count = 0;
+    ids = new int[capacity];
+    names = new string[capacity];
+}
+
+// Destructor
+CourseCatalog::~CourseCatalog() {
+    delete[] ids;
+    delete[] names;
+}
+
+// Add a course (or find it if present), returns its column
+int CourseCatalog::addCourse(int courseId, const string& name) {
+    int column = findCourse(courseId);
+    if (column >= 0) {
+        return column;
+    }
+    if (count == capacity) {
+        int* newIds = new int[capacity * 2];
+        string* newNames = new string[capacity * 2];
+        for (int i = 0; i < count; i++) {
+            newIds[i] = ids[i];
+            newNames[i] = names[i];
+        }
+        delete[] ids;
+        delete[] names;
+        ids = newIds;
+        names = newNames;
+        capacity *= 2;
+    }
+    ids[count] = courseId;
+    names[count] = name;
+    columnOf.insert(courseKey(courseId), count);
+    return count++;
+}
+
+// Column of a course, -1 if not in the catalog
+int CourseCatalog::findCourse(int courseId) const {
+    int column;
+    if (columnOf.find(courseKey(courseId), column)) {
+        return column;
+    }
+    return -1;
+}
+
+int CourseCatalog::getCount() const {
+    return count;
+}
+
+int CourseCatalog::getCourseId(int column) const {
+    return ids[column];
+}
+
+string CourseCatalog::getName(int column) const {
+    return names[column];
+}
+
+// Add the courses of the two student types to a catalog
+void addDefaultCourses(CourseCatalog& catalog) {
+    for (int i = 1; i <= 5; i++) {
+        catalog.addCourse(TYPE1_COURSE_BASE + i, "A" + to_string(i));
+    }
+    for (int i = 1; i <= 3; i++) {
+        catalog.addCourse(TYPE2_COURSE_BASE + i, "B" + to_string(i));
+    }
+}
+
+// Catalog course ID of a course slot
+int defaultCourseId(int courseCount, int index) {
+    int base = (courseCount == 5) ? TYPE1_COURSE_BASE : TYPE2_COURSE_BASE;
+    return base + index + 1;
+}
+
+// Constructor
+EnrollmentMatrix::EnrollmentMatrix() {
+    rowCount = 0;
+    rowIds = nullptr;
+    rowStart = nullptr;
+    columns = nullptr;
+    values = nullptr;
+    entryCount = 0;
+    columnCount = 0;
+    columnIndexValid = false;
+    colStart = nullptr;
+    colRows = nullptr;
+    colValues = nullptr;
+}
+
+// Destructor
+EnrollmentMatrix::~EnrollmentMatrix() {
+    clear();
+}
+
+// Release all arrays
+void EnrollmentMatrix::clear() {
+    delete[] rowIds;
+    delete[] rowStart;
+    delete[] columns;
+    delete[] values;
+    delete[] colStart;
+    delete[] colRows;
+    delete[] colValues;
+    rowIds = nullptr;
+    rowStart = nullptr;
+    columns = nullptr;
+    values = nullptr;
+    colStart = nullptr;
+    colRows = nullptr;
+    colValues = nullptr;
+    rowCount = 0;
+    entryCount = 0;
+    columnCount = 0;
+    columnIndexValid = false;
+}
+
+// Allocate row arrays for the given sizes
+void EnrollmentMatrix::allocate(int rows, long long entries, int courseColumns) {
+    clear();
+    rowCount = rows;
+    entryCount = entries;
+    columnCount = courseColumns;
+    rowIds = new unsigned long long[rows > 0 ? rows : 1];
+    rowStart = new long long[rows + 1];
+    columns = new int[entries > 0 ? entries : 1];
+    values = new double[entries > 0 ? entries : 1];
+    rowStart[0] = 0;
+}
+
+// Build from roster students using the default course of each slot
+void EnrollmentMatrix::buildFromRoster(const Student* const* list, int count, CourseCatalog& catalog) {
+    addDefaultCourses(catalog);
+    long long entries = 0;
+    for (int i = 0; i < count; i++) {
+        entries += list[i]->getCourseCount();
+    }
+    allocate(count, entries, catalog.getCount());
+
+    // Columns of the default course slots, looked up once per build
+    int columns3[3];
+    int columns5[5];
+    for (int k = 0; k < 5; k++) {
+        if (k < 3) {
+            columns3[k] = catalog.findCourse(defaultCourseId(3, k));
+        }
+        columns5[k] = catalog.findCourse(defaultCourseId(5, k));
+    }
+
+    long long e = 0;
+    for (int i = 0; i < count; i++) {
+        rowIds[i] = packStudentId(list[i]->getStudentId());
+        int cc = list[i]->getCourseCount();
+        const int* slotColumns = cc == 5 ? columns5 : columns3;
+        for (int k = 0; k < cc; k++) {
+            // Insertion sort by column: a catalog that already held other
+            // courses may give the slots columns out of order
+            int column = slotColumns[k];
+            double value = list[i]->getScore(k);
+            long long pos = e;
+            while (pos > rowStart[i] && columns[pos - 1] > column) {
+                columns[pos] = columns[pos - 1];
+                values[pos] = values[pos - 1];
+                pos--;
+            }
+            columns[pos] = column;
+            values[pos] = value;
+            e++;
+        }
+        rowStart[i + 1] = e;
+    }
+}
+
+// Build from (student ID, course column, score) triples in any order
+void EnrollmentMatrix::buildFromTriples(const unsigned long long* ids, const int* courseColumns,
+                                        const double* scores, long long n, int courseColumnCount) {
+    // Sort triples by student, then course; stable so the last repeat wins
+    long long* order = new long long[n > 0 ? n : 1];
+    for (long long i = 0; i < n; i++) {
+        order[i] = i;
+    }
+    stable_sort(order, order + n, [ids, courseColumns](long long a, long long b) {
+        if (ids[a] != ids[b]) return ids[a] < ids[b];
+        return courseColumns[a] < courseColumns[b];
+    });
+
+    // Count rows and distinct enrollments
+    int rows = 0;
+    long long entries = 0;
+    for (long long i = 0; i < n; i++) {
+        bool newRow = (i == 0 || ids[order[i]] != ids[order[i - 1]]);
+        if (newRow) rows++;
+        if (newRow || courseColumns[order[i]] != courseColumns[order[i - 1]]) entries++;
+    }
+    allocate(rows, entries, courseColumnCount);
+
+    int r = -1;
+    long long e = 0;
+    for (long long i = 0; i < n; i++) {
+        long long t = order[i];
+        bool newRow = (i == 0 || ids[t] != ids[order[i - 1]]);
+        if (newRow) {
+            if (r >= 0) rowStart[r + 1] = e;
+            r++;
+            rowIds[r] = ids[t];
+        } else if (courseColumns[t] == courseColumns[order[i - 1]]) {
+            values[e - 1] = scores[t];
+            continue;
+        }
+        columns[e] = courseColumns[t];
+        values[e] = scores[t];
+        e++;
+    }
+    if (r >= 0) rowStart[r + 1] = e;
+    delete[] order;
+}
+
+// Group entries by column (counting sort)
+void EnrollmentMatrix::buildColumnIndex() {
+    delete[] colStart;
+    delete[] colRows;
+    delete[] colValues;
+    colStart = new long long[columnCount + 1];
+    colRows = new int[entryCount > 0 ? entryCount : 1];
+    colValues = new double[entryCount > 0 ? entryCount : 1];
+
+    for (int c = 0; c <= columnCount; c++) {
+        colStart[c] = 0;
+    }
+    for (long long e = 0; e < entryCount; e++) {
+        colStart[columns[e] + 1]++;
+    }
+    for (int c = 0; c < columnCount; c++) {
+        colStart[c + 1] += colStart[c];
+    }
+
+    long long* next = new long long[columnCount > 0 ? columnCount : 1];
+    for (int c = 0; c < columnCount; c++) {
+        next[c] = colStart[c];
+    }
+    for (int r = 0; r < rowCount; r++) {
+        for (long long e = rowStart[r]; e < rowStart[r + 1]; e++) {
+            long long pos = next[columns[e]]++;
+            colRows[pos] = r;
+            colValues[pos] = values[e];
+        }
+    }
+    delete[] next;
+    columnIndexValid = true;
+}
+
+int EnrollmentMatrix::getRowCount() const {
+    return rowCount;
+}
+
+long long EnrollmentMatrix::getEntryCount() const {
+    return entryCount;
+}
+
+unsigned long long EnrollmentMatrix::getRowId(int row) const {
+    return rowIds[row];
+}
+
+int EnrollmentMatrix::getEnrolledCount(int row) const {
+    return (int)(rowStart[row + 1] - rowStart[row]);
+}
+
+int EnrollmentMatrix::getEnrolledColumn(int row, int k) const {
+    return columns[rowStart[row] + k];
+}
+
+double EnrollmentMatrix::getEnrolledScore(int row, int k) const {
+    return values[rowStart[row] + k];
+}
+
+// Score of a student in a course (binary search in the sorted row)
+bool EnrollmentMatrix::getScore(int row, int column, double& score) const {
+    if (row < 0 || row >= rowCount) {
+        return false;
+    }
+    const int* first = columns + rowStart[row];
+    const int* last = columns + rowStart[row + 1];
+    const int* pos = lower_bound(first, last, column);
+    if (pos == last || *pos != column) {
+        return false;
+    }
+    score = values[pos - columns];
+    return true;
+}
+
+// Change the score of an existing enrollment
+bool EnrollmentMatrix::setScore(int row, int column, double score) {
+    if (row < 0 || row >= rowCount || !isValidScore(score)) {
+        return false;
+    }
+    int* first = columns + rowStart[row];
+    int* last = columns + rowStart[row + 1];
+    int* pos = lower_bound(first, last, column);
+    if (pos == last || *pos != column) {
+        return false;
+    }
+    values[pos - columns] = score;
+    columnIndexValid = false;
+    return true;
+}
+
+// Statistics of one course over enrolled students only
+int EnrollmentMatrix::courseStats(int column, double& sum, double& maxScore, double& minScore) {
+    sum = 0;
+    maxScore = -1;
+    minScore = 101;
+    if (column < 0 || column >= columnCount) {
+        return 0;
+    }
+    if (!columnIndexValid) {
+        buildColumnIndex();
+    }
+    for (long long p = colStart[column]; p < colStart[column + 1]; p++) {
+        double score = colValues[p];
+        sum += score;
+        if (score > maxScore) maxScore = score;
+        if (score < minScore) minScore = score;
+    }
+    return (int)(colStart[column + 1] - colStart[column]);
+}
+
+// Bytes used by the matrix arrays
+long long EnrollmentMatrix::memoryBytes() const {
+    long long bytes = rowCount * (long long)sizeof(unsigned long long)
+                    + (rowCount + 1) * (long long)sizeof(long long)
+                    + entryCount * (long long)(sizeof(int) + sizeof(double));
+    if (columnIndexValid) {
+        bytes += (columnCount + 1) * (long long)sizeof(long long)
+               + entryCount * (long long)(sizeof(int) + sizeof(double));
+    }
+    return bytes;
+}
+
+// Enrollment file lines are validated in column batches of this size
+static const int ENROLLMENT_BATCH_ROWS = 4096;
+
+// Parsed lines waiting for validation, one array per field
+struct EnrollmentBatch {
+    string ids[ENROLLMENT_BATCH_ROWS];
+    int courseIds[ENROLLMENT_BATCH_ROWS];
+    double scores[ENROLLMENT_BATCH_ROWS];
+    unsigned long long packed[ENROLLMENT_BATCH_ROWS];
+    unsigned long long errors[ENROLLMENT_BATCH_ROWS / 64];
+    int rows;
+};
+
+// Valid rows collected for buildFromTriples
+struct EnrollmentTriples {
+    unsigned long long* ids;
+    int* courseColumns;
+    double* scores;
+    long long count;
+    long long capacity;
+};
+
+// Add one triple, doubling the arrays when full
+static void appendTriple(EnrollmentTriples& t, unsigned long long id, int column, double score) {
+    if (t.count == t.capacity) {
+        long long newCapacity = t.capacity * 2;
+        unsigned long long* newIds = new unsigned long long[newCapacity];
+        int* newColumns = new int[newCapacity];
+        double* newScores = new double[newCapacity];
+        for (long long i = 0; i < t.count; i++) {
+            newIds[i] = t.ids[i];
+            newColumns[i] = t.courseColumns[i];
+            newScores[i] = t.scores[i];
+        }
+        delete[] t.ids;
+        delete[] t.courseColumns;
+        delete[] t.scores;
+        t.ids = newIds;
+        t.courseColumns = newColumns;
+        t.scores = newScores;
+        t.capacity = newCapacity;
+    }
+    t.ids[t.count] = id;
+    t.courseColumns[t.count] = column;
+    t.scores[t.count] = score;
+    t.count++;
+}
+
+// Validate a batch column by column, then keep its valid rows
+static void flushEnrollmentBatch(EnrollmentBatch& batch, CourseCatalog& catalog,
+                                 EnrollmentTriples& triples, long long& badRows) {
+    int rows = batch.rows;
+    clearErrorBitmap(batch.errors, rows);
+    validateIdColumn(batch.ids, rows, batch.packed, batch.errors);
+    validateScoreColumn(batch.scores, rows, batch.errors);
+    for (int r = 0; r < rows; r++) {
+        if (rowHasError(batch.errors, r)) {
+            badRows++;
+            continue;
+        }
+        int column = catalog.addCourse(batch.courseIds[r], to_string(batch.courseIds[r]));
+        appendTriple(triples, batch.packed[r], column, batch.scores[r]);
+    }
+    batch.rows = 0;
+}
+
+// Read an enrollment file into a matrix
+bool loadEnrollmentFile(const string& fileName, CourseCatalog& catalog,
+                        EnrollmentMatrix& matrix, long long& badRows) {
+    ifstream file(fileName.c_str());
+    if (!file) {
+        return false;
+    }
+
+    EnrollmentTriples triples;
+    triples.capacity = 1024;
+    triples.count = 0;
+    triples.ids = new unsigned long long[triples.capacity];
+    triples.courseColumns = new int[triples.capacity];
+    triples.scores = new double[triples.capacity];
+    EnrollmentBatch* batch = new EnrollmentBatch;
+    batch->rows = 0;
+    badRows = 0;
+
+    // One row per line, so a malformed line is counted and skipped
+    // instead of ending the read. IDs and scores are checked when the
+    // batch is validated.
+    string line;
+    string extra;
+    while (getline(file, line)) {
+        istringstream fields(line);
+        int r = batch->rows;
+        if (!(fields >> batch->ids[r])) {
+            continue;                    // blank line
+        }
+        if (!(fields >> batch->courseIds[r] >> batch->scores[r]) || (fields >> extra)) {
+            badRows++;
+            continue;
+        }
+        batch->rows++;
+        if (batch->rows == ENROLLMENT_BATCH_ROWS) {
+            flushEnrollmentBatch(*batch, catalog, triples, badRows);
+        }
+    }
+    flushEnrollmentBatch(*batch, catalog, triples, badRows);
+
+    matrix.buildFromTriples(triples.ids, triples.courseColumns, triples.scores,
+                            triples.count, catalog.getCount());
+    delete batch;
+    delete[] triples.ids;
+    delete[] triples.courseColumns;
+    delete[] triples.scores;
+    return true;
+}
@@ -0,0 +1,114 @@
+// Enrollment.h - Course catalog and sparse enrollment/score matrix
+#ifndef ENROLLMENT_H
+#define ENROLLMENT_H
+
+#include "Student.h"
+#include "IdHash.h"
+
+// Catalog IDs of the courses taken by the two student types
+const int TYPE1_COURSE_BASE = 100;   // 5-course students: 101-105
+const int TYPE2_COURSE_BASE = 200;   // 3-course students: 201-203
+
+// List of courses, each course gets a column number in add order.
+// Course IDs are looked up through a hash table.
+class CourseCatalog {
+private:
+    int* ids;
+    string* names;
+    int count;
+    int capacity;
+    IdHash columnOf;             // course ID -> column
+
+    // Not copyable
+    CourseCatalog(const CourseCatalog& other);
+    CourseCatalog& operator=(const CourseCatalog& other);
+
+public:
+    CourseCatalog();
+    ~CourseCatalog();
+
+    // Add a course (or find it if present), returns its column
+    int addCourse(int courseId, const string& name);
+
+    // Column of a course, -1 if not in the catalog
+    int findCourse(int courseId) const;
+
+    int getCount() const;
+    int getCourseId(int column) const;
+    string getName(int column) const;
+};
+
+// Add the courses of the two student types to a catalog
+void addDefaultCourses(CourseCatalog& catalog);
+
+// Catalog course ID of course slot `index` for a student with `courseCount` courses
+int defaultCourseId(int courseCount, int index);
+
+// Compressed sparse row matrix: one row per student, one entry per enrollment.
+// A column index (entries grouped by course) is built on demand for
+// per-course access.
+class EnrollmentMatrix {
+private:
+    int rowCount;
+    unsigned long long* rowIds;      // packed student ID of each row
+    long long* rowStart;             // rowCount + 1 offsets into entries
+    int* columns;                    // course column of each entry (sorted per row)
+    double* values;                  // score of each entry
+    long long entryCount;
+    int columnCount;
+
+    // Column index
+    bool columnIndexValid;
+    long long* colStart;             // columnCount + 1 offsets
+    int* colRows;                    // row of each entry, grouped by column
+    double* colValues;               // score of each entry, grouped by column
+
+    // Not copyable
+    EnrollmentMatrix(const EnrollmentMatrix& other);
+    EnrollmentMatrix& operator=(const EnrollmentMatrix& other);
+
+    void clear();
+    void allocate(int rows, long long entries, int courseColumns);
+    void buildColumnIndex();
+
+public:
+    EnrollmentMatrix();
+    ~EnrollmentMatrix();
+
+    // Build from roster students using the default course of each slot
+    void buildFromRoster(const Student* const* list, int count, CourseCatalog& catalog);
+
+    // Build from (student ID, course column, score) triples in any order.
+    // Repeated (student, course) pairs keep the last score.
+    void buildFromTriples(const unsigned long long* ids, const int* courseColumns,
+                          const double* scores, long long n, int courseColumnCount);
+
+    int getRowCount() const;
+    long long getEntryCount() const;
+    unsigned long long getRowId(int row) const;
+
+    // Enrollments of one student
+    int getEnrolledCount(int row) const;
+    int getEnrolledColumn(int row, int k) const;
+    double getEnrolledScore(int row, int k) const;
+
+    // Score of a student in a course, false if not enrolled
+    bool getScore(int row, int column, double& score) const;
+    bool setScore(int row, int column, double score);
+
+    // Statistics of one course over enrolled students only
+    int courseStats(int column, double& sum, double& maxScore, double& minScore);
+
+    // Bytes used by the matrix arrays
+    long long memoryBytes() const;
+};
+
+// Read an enrollment file (one "studentId courseId score" per line) into a
+// matrix. Lines are checked in column batches with the Validate.h
+// validators; malformed lines, bad IDs and scores outside 0-100 are counted
+// in badRows and skipped. New course IDs are added to the catalog.
+// Returns false if the file cannot be opened.
+bool loadEnrollmentFile(const string& fileName, CourseCatalog& catalog,
+                        EnrollmentMatrix& matrix, long long& badRows);
+
+#endif // ENROLLMENT_H
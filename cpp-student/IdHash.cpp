@@ -0,0 +1,139 @@
+// IdHash.cpp - Hash table from packed student ID to an integer
+#include "IdHash.h"
+
+// Mix the bits of an ID so sequential IDs spread over the table
+static unsigned long long hashId(unsigned long long id) {
+    id ^= id >> 33;
+    id *= 0xFF51AFD7ED558CCDULL;
+    id ^= id >> 33;
+    return id;
+}
+
+// Constructor
+IdHash::IdHash() {
+    capacity = 16;
+    size = 0;
+    keys = new unsigned long long[capacity];
+    values = new int[capacity];
+    for (long long i = 0; i < capacity; i++) {
+        keys[i] = 0;
+    }
+}
+
+// Destructor
+IdHash::~IdHash() {
+    delete[] keys;
+    delete[] values;
+}
+
+// Move all entries into a table of the given size
+void IdHash::rehash(long long newCapacity) {
+    unsigned long long* oldKeys = keys;
+    int* oldValues = values;
+    long long oldCapacity = capacity;
+
+    capacity = newCapacity;
+    keys = new unsigned long long[capacity];
+    values = new int[capacity];
+    for (long long i = 0; i < capacity; i++) {
+        keys[i] = 0;
+    }
+    long long mask = capacity - 1;
+    for (long long i = 0; i < oldCapacity; i++) {
+        if (oldKeys[i] != 0) {
+            long long pos = (long long)(hashId(oldKeys[i] - 1) & mask);
+            while (keys[pos] != 0) {
+                pos = (pos + 1) & mask;
+            }
+            keys[pos] = oldKeys[i];
+            values[pos] = oldValues[i];
+        }
+    }
+    delete[] oldKeys;
+    delete[] oldValues;
+}
+
+void IdHash::clear() {
+    for (long long i = 0; i < capacity; i++) {
+        keys[i] = 0;
+    }
+    size = 0;
+}
+
+// Keep the load factor at or below one half
+void IdHash::reserve(long long n) {
+    long long needed = capacity;
+    while (needed < n * 2) {
+        needed *= 2;
+    }
+    if (needed != capacity) {
+        rehash(needed);
+    }
+}
+
+void IdHash::insert(unsigned long long id, int value) {
+    if ((size + 1) * 2 > capacity) {
+        rehash(capacity * 2);
+    }
+    long long mask = capacity - 1;
+    long long pos = (long long)(hashId(id) & mask);
+    while (keys[pos] != 0 && keys[pos] != id + 1) {
+        pos = (pos + 1) & mask;
+    }
+    if (keys[pos] == 0) {
+        size++;
+    }
+    keys[pos] = id + 1;
+    values[pos] = value;
+}
+
+bool IdHash::find(unsigned long long id, int& value) const {
+    long long mask = capacity - 1;
+    long long pos = (long long)(hashId(id) & mask);
+    while (keys[pos] != 0) {
+        if (keys[pos] == id + 1) {
+            value = values[pos];
+            return true;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return false;
+}
+
+bool IdHash::erase(unsigned long long id) {
+    long long mask = capacity - 1;
+    long long pos = (long long)(hashId(id) & mask);
+    while (keys[pos] != id + 1) {
+        if (keys[pos] == 0) {
+            return false;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    // Shift following entries back so every probe chain stays unbroken
+    long long hole = pos;
+    long long next = (pos + 1) & mask;
+    while (keys[next] != 0) {
+        long long home = (long long)(hashId(keys[next] - 1) & mask);
+        // Move the entry if its home is not in (hole, next]
+        bool inRange = (hole < next) ? (home > hole && home <= next)
+                                     : (home > hole || home <= next);
+        if (!inRange) {
+            keys[hole] = keys[next];
+            values[hole] = values[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    keys[hole] = 0;
+    size--;
+    return true;
+}
+
+long long IdHash::getSize() const {
+    return size;
+}
+
+long long IdHash::memoryBytes() const {
+    return capacity * (long long)(sizeof(unsigned long long) + sizeof(int));
+}
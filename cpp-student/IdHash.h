@@ -0,0 +1,43 @@
+// IdHash.h - Hash table from packed student ID to an integer
+#ifndef IDHASH_H
+#define IDHASH_H
+
+// Open addressing with linear probing. Keys are stored as ID + 1 so that
+// 0 marks an empty cell; erase shifts later entries back (no tombstones).
+class IdHash {
+private:
+    unsigned long long* keys;
+    int* values;
+    long long capacity;          // power of two
+    long long size;
+
+    // Not copyable
+    IdHash(const IdHash& other);
+    IdHash& operator=(const IdHash& other);
+
+    void rehash(long long newCapacity);
+
+public:
+    IdHash();
+    ~IdHash();
+
+    // Remove all entries (keeps the table size)
+    void clear();
+
+    // Make room for n entries without growing
+    void reserve(long long n);
+
+    // Insert or overwrite
+    void insert(unsigned long long id, int value);
+
+    // Look up an ID, false if not present
+    bool find(unsigned long long id, int& value) const;
+
+    // Remove an ID, false if not present
+    bool erase(unsigned long long id);
+
+    long long getSize() const;
+    long long memoryBytes() const;
+};
+
+#endif // IDHASH_H
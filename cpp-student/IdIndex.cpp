@@ -0,0 +1,257 @@
+// IdIndex.cpp - Adaptive student ID index (direct-addressed dense ranges + hash)
+#include "IdIndex.h"
+
+static const unsigned long long ID_RANGE_MASK = ID_RANGE_SIZE - 1;
+
+// Constructor
+IdIndex::IdIndex() {
+    directoryBase = 0;
+    directorySize = 0;
+    arrays = nullptr;
+    counts = nullptr;
+    denseRanges = 0;
+    denseEntries = 0;
+    windowPeak = 0;
+    for (int k = 0; k < ID_OUTLIER_RANGES; k++) {
+        outlierCounts[k] = 0;
+    }
+}
+
+// Destructor
+IdIndex::~IdIndex() {
+    clear();
+}
+
+// Remove all entries
+void IdIndex::clear() {
+    for (int d = 0; d < directorySize; d++) {
+        delete[] arrays[d];
+    }
+    delete[] arrays;
+    delete[] counts;
+    arrays = nullptr;
+    counts = nullptr;
+    directoryBase = 0;
+    directorySize = 0;
+    denseRanges = 0;
+    denseEntries = 0;
+    windowPeak = 0;
+    for (int k = 0; k < ID_OUTLIER_RANGES; k++) {
+        outlierCounts[k] = 0;
+    }
+    hash.clear();
+}
+
+// Make room for n entries
+void IdIndex::reserve(long long n) {
+    hash.reserve(n < ID_RANGE_SIZE ? n : ID_RANGE_SIZE);
+}
+
+// Count one ID of a range outside the window (Misra-Gries: a full table
+// decrements every count). Returns the range's count, 0 if not kept.
+int IdIndex::countOutlier(unsigned long long range) {
+    int freeSlot = -1;
+    for (int k = 0; k < ID_OUTLIER_RANGES; k++) {
+        if (outlierCounts[k] > 0 && outlierRanges[k] == range) {
+            return ++outlierCounts[k];
+        }
+        if (outlierCounts[k] == 0 && freeSlot < 0) {
+            freeSlot = k;
+        }
+    }
+    if (freeSlot >= 0) {
+        outlierRanges[freeSlot] = range;
+        outlierCounts[freeSlot] = 1;
+        return 1;
+    }
+    for (int k = 0; k < ID_OUTLIER_RANGES; k++) {
+        outlierCounts[k]--;
+    }
+    return 0;
+}
+
+// Directory position of a range, extending the window if asked and the
+// window stays within ID_MAX_DIRECTORY ranges. -1 if the range is outside.
+int IdIndex::directoryIndex(unsigned long long range, bool extend) {
+    if (range - directoryBase < (unsigned long long)directorySize) {
+        return (int)(range - directoryBase);
+    }
+    if (!extend) {
+        return -1;
+    }
+
+    unsigned long long newBase = range;
+    unsigned long long newEnd = range + 1;
+    if (directorySize > 0) {
+        unsigned long long oldEnd = directoryBase + directorySize;
+        if (directoryBase < newBase) newBase = directoryBase;
+        if (oldEnd > newEnd) newEnd = oldEnd;
+    }
+    int carried = 0;
+    if (newEnd - newBase > (unsigned long long)ID_MAX_DIRECTORY) {
+        if (denseRanges > 0) {
+            return -1;
+        }
+        // No dense range yet. The range stays in the hash unless it now
+        // has more IDs than any range of the window, which was then placed
+        // by outliers: move the window to it (old window counts are dropped,
+        // their IDs stay in the hash).
+        int seen = countOutlier(range);
+        if (seen <= windowPeak) {
+            return -1;
+        }
+        for (int k = 0; k < ID_OUTLIER_RANGES; k++) {
+            if (outlierRanges[k] == range) {
+                outlierCounts[k] = 0;
+            }
+        }
+        carried = seen - 1;          // the caller counts the current ID
+        windowPeak = carried;
+        delete[] arrays;
+        delete[] counts;
+        arrays = nullptr;
+        counts = nullptr;
+        directorySize = 0;
+        newBase = range;
+        newEnd = range + 1;
+    }
+
+    int newSize = (int)(newEnd - newBase);
+    int** newArrays = new int*[newSize];
+    int* newCounts = new int[newSize];
+    for (int d = 0; d < newSize; d++) {
+        newArrays[d] = nullptr;
+        newCounts[d] = 0;
+    }
+    int shift = (int)(directoryBase - newBase);
+    for (int d = 0; d < directorySize; d++) {
+        newArrays[d + shift] = arrays[d];
+        newCounts[d + shift] = counts[d];
+    }
+    delete[] arrays;
+    delete[] counts;
+    arrays = newArrays;
+    counts = newCounts;
+    directoryBase = newBase;
+    directorySize = newSize;
+    int d = (int)(range - directoryBase);
+    counts[d] += carried;
+    return d;
+}
+
+// Move the IDs of a range from the hash into a new array
+void IdIndex::promote(int d) {
+    int* cells = new int[ID_RANGE_SIZE];
+    unsigned long long base = (directoryBase + d) << ID_RANGE_BITS;
+    int moved = 0;
+    for (int k = 0; k < ID_RANGE_SIZE; k++) {
+        int value;
+        if (hash.find(base + k, value)) {
+            cells[k] = value;
+            hash.erase(base + k);
+            moved++;
+        } else {
+            cells[k] = -1;
+        }
+    }
+    arrays[d] = cells;
+    counts[d] = moved;
+    denseRanges++;
+    denseEntries += moved;
+}
+
+// Move the IDs of a range back into the hash and free its array
+void IdIndex::demote(int d) {
+    int* cells = arrays[d];
+    unsigned long long base = (directoryBase + d) << ID_RANGE_BITS;
+    for (int k = 0; k < ID_RANGE_SIZE; k++) {
+        if (cells[k] >= 0) {
+            hash.insert(base + k, cells[k]);
+        }
+    }
+    delete[] cells;
+    arrays[d] = nullptr;
+    denseRanges--;
+    denseEntries -= counts[d];
+}
+
+void IdIndex::insert(unsigned long long id, int value) {
+    int d = directoryIndex(id >> ID_RANGE_BITS, true);
+    if (d >= 0 && arrays[d] != nullptr) {
+        int& cell = arrays[d][id & ID_RANGE_MASK];
+        if (cell < 0) {
+            counts[d]++;
+            denseEntries++;
+        }
+        cell = value;
+        return;
+    }
+
+    long long before = hash.getSize();
+    hash.insert(id, value);
+    if (d >= 0 && hash.getSize() != before) {
+        counts[d]++;
+        if (counts[d] > windowPeak) {
+            windowPeak = counts[d];
+        }
+        if (counts[d] >= ID_RANGE_PROMOTE) {
+            promote(d);
+        }
+    }
+}
+
+bool IdIndex::find(unsigned long long id, int& value) const {
+    // Unsigned wrap-around also rejects ranges below the window
+    unsigned long long d = (id >> ID_RANGE_BITS) - directoryBase;
+    if (d < (unsigned long long)directorySize && arrays[d] != nullptr) {
+        int cell = arrays[d][id & ID_RANGE_MASK];
+        if (cell < 0) {
+            return false;
+        }
+        value = cell;
+        return true;
+    }
+    return hash.find(id, value);
+}
+
+bool IdIndex::erase(unsigned long long id) {
+    int d = directoryIndex(id >> ID_RANGE_BITS, false);
+    if (d >= 0 && arrays[d] != nullptr) {
+        int& cell = arrays[d][id & ID_RANGE_MASK];
+        if (cell < 0) {
+            return false;
+        }
+        cell = -1;
+        counts[d]--;
+        denseEntries--;
+        if (counts[d] <= ID_RANGE_DEMOTE) {
+            demote(d);
+        }
+        return true;
+    }
+
+    if (!hash.erase(id)) {
+        return false;
+    }
+    if (d >= 0 && counts[d] > 0) {
+        counts[d]--;
+    }
+    return true;
+}
+
+long long IdIndex::getSize() const {
+    return hash.getSize() + denseEntries;
+}
+
+int IdIndex::getDenseRanges() const {
+    return denseRanges;
+}
+
+long long IdIndex::getDenseEntries() const {
+    return denseEntries;
+}
+
+long long IdIndex::memoryBytes() const {
+    return hash.memoryBytes() + (long long)denseRanges * ID_RANGE_SIZE * sizeof(int)
+         + (long long)directorySize * (sizeof(int*) + sizeof(int));
+}
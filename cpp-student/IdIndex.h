@@ -0,0 +1,81 @@
+// IdIndex.h - Adaptive student ID index (direct-addressed dense ranges + hash)
+#ifndef IDINDEX_H
+#define IDINDEX_H
+
+#include "IdHash.h"
+
+// IDs per range: a range covers the IDs that share id >> ID_RANGE_BITS
+const int ID_RANGE_BITS = 16;
+const int ID_RANGE_SIZE = 1 << ID_RANGE_BITS;
+
+// A range switches to a direct array once it holds this many IDs (one
+// eighth full, where the array is no larger than the hash cells it replaces)
+// and back to the hash when it drops to a quarter of that
+const int ID_RANGE_PROMOTE = ID_RANGE_SIZE / 8;
+const int ID_RANGE_DEMOTE = ID_RANGE_PROMOTE / 4;
+
+// Ranges tracked in the directory (4096 ranges = 268 million IDs)
+const int ID_MAX_DIRECTORY = 4096;
+
+// Ranges outside the directory window counted while no range is dense
+const int ID_OUTLIER_RANGES = 8;
+
+// Student IDs are issued in dense yearly blocks, so most IDs fall in a few
+// ranges. Dense ranges get an array indexed by (id - range base); a lookup
+// is one directory load and one array load. Other IDs, and IDs too far
+// from the directory window, stay in an IdHash. Until a range is dense the
+// window follows the busiest range, counted in a small side table.
+class IdIndex {
+private:
+    IdHash hash;                 // IDs of ranges without an array
+
+    // Directory of ranges [directoryBase, directoryBase + directorySize)
+    unsigned long long directoryBase;
+    int directorySize;
+    int** arrays;                // per range: ID_RANGE_SIZE values (-1 = empty) or nullptr
+    int* counts;                 // per range: IDs stored (array or hash)
+    int denseRanges;
+    long long denseEntries;
+    int windowPeak;              // largest count in the window while no range is dense
+
+    // Ranges outside the window (heavy-hitter counts). One that overtakes
+    // windowPeak moves the window, so outliers alone never move it.
+    unsigned long long outlierRanges[ID_OUTLIER_RANGES];
+    int outlierCounts[ID_OUTLIER_RANGES];
+
+    // Not copyable
+    IdIndex(const IdIndex& other);
+    IdIndex& operator=(const IdIndex& other);
+
+    int directoryIndex(unsigned long long range, bool extend);
+    int countOutlier(unsigned long long range);
+    void promote(int d);
+    void demote(int d);
+
+public:
+    IdIndex();
+    ~IdIndex();
+
+    // Remove all entries
+    void clear();
+
+    // Make room for n entries (most IDs end up in range arrays, so only
+    // part of n is reserved in the hash)
+    void reserve(long long n);
+
+    // Insert or overwrite, value must not be negative
+    void insert(unsigned long long id, int value);
+
+    // Look up an ID, false if not present (safe from several reader threads)
+    bool find(unsigned long long id, int& value) const;
+
+    // Remove an ID, false if not present
+    bool erase(unsigned long long id);
+
+    long long getSize() const;
+    int getDenseRanges() const;
+    long long getDenseEntries() const;
+    long long memoryBytes() const;
+};
+
+#endif // IDINDEX_H
@@ -0,0 +1,420 @@
+// PagedRoster.cpp - Disk-backed roster with a bounded page cache
+//
+// File layout: "SPAG", version (4 bytes), record count (8 bytes), then pages of
+// RECORDS_PER_PAGE fixed-size records. The last page is padded to full size.
+//
+// Pages are cached in a fixed number of frames and replaced with the CLOCK
+// algorithm. When a scan moves to the next page (or read-ahead is enabled),
+// a miss reads up to PREFETCH_PAGES consecutive pages in one request.
+#include "PagedRoster.h"
+#include "ChangeFeed.h"
+#include "AuditLog.h"
+#include "Validate.h"
+#include <cstring>
+
+static const char PAGE_MAGIC[4] = {'S', 'P', 'A', 'G'};
+static const int PAGE_VERSION = 1;
+static const int PAGE_HEADER_BYTES = 16;
+static const long long PAGE_BYTES = RECORDS_PER_PAGE * (long long)sizeof(StudentRecord);
+
+// Convert a Student object to a fixed-size record
+void toRecord(const Student& s, StudentRecord& rec) {
+    memset(&rec, 0, sizeof(rec));
+    string id = s.getStudentId();
+    string n = s.getName();
+    memcpy(rec.studentId, id.data(), id.length() < 10 ? id.length() : 10);
+    memcpy(rec.name, n.data(), n.length() < 8 ? n.length() : 8);
+    rec.age = (unsigned char)s.getAge();
+    rec.gender = s.getGender();
+    rec.courseCount = (unsigned char)s.getCourseCount();
+    for (int i = 0; i < s.getCourseCount() && i < 5; i++) {
+        rec.scores[i] = s.getScore(i);
+    }
+    rec.avgScore = s.getAvgScore();
+}
+
+// Check a record read from a file before it becomes a Student
+bool isValidRecord(const StudentRecord& rec) {
+    unsigned long long packed;
+    if (!parseId10(rec.studentId, packed) || rec.name[0] == '\0'
+        || rec.age == 0 || rec.age > 150 || !isValidGender(rec.gender)
+        || (rec.courseCount != 3 && rec.courseCount != 5)) {
+        return false;
+    }
+    unsigned long long errors[1] = {0};
+    return validateScoreColumn(rec.scores, rec.courseCount, errors) == 0;
+}
+
+// Convert a fixed-size record back to a Student object
+bool fromRecord(const StudentRecord& rec, Student& s) {
+    if (!isValidRecord(rec)) {
+        return false;
+    }
+    // Filled from disk, not a roster change
+    ChangeFeedMute mute;
+    AuditMute auditMute;
+    int nameLength = 0;
+    while (nameLength < 8 && rec.name[nameLength] != '\0') {
+        nameLength++;
+    }
+    s = Student(string(rec.studentId, 10), string(rec.name, nameLength),
+                rec.age, rec.gender, rec.courseCount);
+    for (int i = 0; i < rec.courseCount; i++) {
+        s.setScore(i, rec.scores[i]);
+    }
+    s.calcAverage();
+    return true;
+}
+
+// Constructor
+PagedRoster::PagedRoster() {
+    recordCount = 0;
+    pageCount = 0;
+    frameCount = 0;
+    frames = nullptr;
+    frameData = nullptr;
+    pageToFrame = nullptr;
+    pageTableSize = 0;
+    clockHand = 0;
+    lastPage = -2;
+    sequential = false;
+    hits = 0;
+    misses = 0;
+    pagesRead = 0;
+    pagesWritten = 0;
+}
+
+// Destructor
+PagedRoster::~PagedRoster() {
+    close();
+}
+
+// Allocate cache frames within the memory budget
+bool PagedRoster::setupCache(long long cacheBytes) {
+    long long count = cacheBytes / PAGE_BYTES;
+    if (count < 2) {
+        count = 2;
+    }
+    if (count > 1000000000LL) {
+        count = 1000000000LL;
+    }
+    frameCount = (int)count;
+    frames = new Frame[frameCount];
+    frameData = new StudentRecord[(long long)frameCount * RECORDS_PER_PAGE];
+    for (int f = 0; f < frameCount; f++) {
+        frames[f].page = -1;
+        frames[f].dirty = false;
+        frames[f].referenced = false;
+    }
+    clockHand = 0;
+    lastPage = -2;
+    hits = 0;
+    misses = 0;
+    pagesRead = 0;
+    pagesWritten = 0;
+    growPageTable(pageCount);
+    return true;
+}
+
+// Make sure the page table covers the given number of pages
+void PagedRoster::growPageTable(long long pages) {
+    if (pages <= pageTableSize && pageToFrame != nullptr) {
+        return;
+    }
+    long long newSize = pageTableSize * 2;
+    if (newSize < pages) newSize = pages;
+    if (newSize < 16) newSize = 16;
+    int* table = new int[newSize];
+    for (long long p = 0; p < newSize; p++) {
+        table[p] = (p < pageTableSize) ? pageToFrame[p] : -1;
+    }
+    delete[] pageToFrame;
+    pageToFrame = table;
+    pageTableSize = newSize;
+}
+
+// Create a page file from an in-memory roster
+bool PagedRoster::create(const string& fileName, const Student* const* list, int count, long long cacheBytes) {
+    close();
+    ofstream out(fileName.c_str(), ios::binary | ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    char header[PAGE_HEADER_BYTES];
+    memset(header, 0, sizeof(header));
+    memcpy(header, PAGE_MAGIC, 4);
+    unsigned int version = PAGE_VERSION;
+    unsigned long long total = count;
+    memcpy(header + 4, &version, 4);
+    memcpy(header + 8, &total, 8);
+    out.write(header, PAGE_HEADER_BYTES);
+
+    StudentRecord* page = new StudentRecord[RECORDS_PER_PAGE];
+    for (int start = 0; start < count; start += RECORDS_PER_PAGE) {
+        memset(page, 0, PAGE_BYTES);
+        for (int i = 0; i < RECORDS_PER_PAGE && start + i < count; i++) {
+            toRecord(*list[start + i], page[i]);
+        }
+        out.write((const char*)page, PAGE_BYTES);
+    }
+    delete[] page;
+    out.close();
+    if (!out) {
+        return false;
+    }
+    return open(fileName, cacheBytes);
+}
+
+// Open an existing page file
+bool PagedRoster::open(const string& fileName, long long cacheBytes) {
+    close();
+    file.open(fileName.c_str(), ios::in | ios::out | ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    char header[PAGE_HEADER_BYTES];
+    file.read(header, PAGE_HEADER_BYTES);
+    unsigned int version = 0;
+    unsigned long long total = 0;
+    memcpy(&version, header + 4, 4);
+    memcpy(&total, header + 8, 8);
+    if (!file || memcmp(header, PAGE_MAGIC, 4) != 0 || version != PAGE_VERSION) {
+        file.close();
+        return false;
+    }
+
+    // The record count must match the pages in the file
+    file.seekg(0, ios::end);
+    long long fileSize = (long long)file.tellg();
+    long long pages = (fileSize - PAGE_HEADER_BYTES) / PAGE_BYTES;
+    if (fileSize < PAGE_HEADER_BYTES || (fileSize - PAGE_HEADER_BYTES) % PAGE_BYTES != 0
+        || total > (unsigned long long)pages * RECORDS_PER_PAGE
+        || total + RECORDS_PER_PAGE <= (unsigned long long)pages * RECORDS_PER_PAGE) {
+        file.close();
+        return false;
+    }
+
+    recordCount = (long long)total;
+    pageCount = pages;
+    return setupCache(cacheBytes);
+}
+
+// Write dirty pages and close the file
+void PagedRoster::close() {
+    if (file.is_open()) {
+        flush();
+        file.close();
+    }
+    delete[] frames;
+    delete[] frameData;
+    delete[] pageToFrame;
+    frames = nullptr;
+    frameData = nullptr;
+    pageToFrame = nullptr;
+    frameCount = 0;
+    pageTableSize = 0;
+    recordCount = 0;
+    pageCount = 0;
+}
+
+bool PagedRoster::isOpen() const {
+    return file.is_open();
+}
+
+long long PagedRoster::size() const {
+    return recordCount;
+}
+
+// Choose a frame to reuse (CLOCK replacement). A dirty victim is written
+// first; if that fails the page stays cached and -1 is returned.
+int PagedRoster::pickVictim() {
+    while (true) {
+        int f = clockHand;
+        clockHand = (clockHand + 1) % frameCount;
+        if (frames[f].page == -1) {
+            return f;
+        }
+        if (frames[f].referenced) {
+            frames[f].referenced = false;
+            continue;
+        }
+        if (frames[f].dirty && !writeFrame(f)) {
+            return -1;
+        }
+        pageToFrame[frames[f].page] = -1;
+        frames[f].page = -1;
+        return f;
+    }
+}
+
+// Write one cached page back to the file
+bool PagedRoster::writeFrame(int f) {
+    file.clear();
+    file.seekp(PAGE_HEADER_BYTES + frames[f].page * PAGE_BYTES);
+    file.write((const char*)(frameData + (long long)f * RECORDS_PER_PAGE), PAGE_BYTES);
+    if (!file) {
+        return false;
+    }
+    frames[f].dirty = false;
+    pagesWritten++;
+    return true;
+}
+
+// Read pages [firstPage, firstPage + pages) into the cache with one request
+bool PagedRoster::loadPages(long long firstPage, int pages) {
+    StudentRecord* buffer = new StudentRecord[(long long)pages * RECORDS_PER_PAGE];
+    file.clear();
+    file.seekg(PAGE_HEADER_BYTES + firstPage * PAGE_BYTES);
+    file.read((char*)buffer, pages * PAGE_BYTES);
+    if (!file) {
+        delete[] buffer;
+        return false;
+    }
+
+    for (int i = 0; i < pages; i++) {
+        int f = pickVictim();
+        if (f < 0) {
+            delete[] buffer;
+            return false;
+        }
+        memcpy(frameData + (long long)f * RECORDS_PER_PAGE,
+               buffer + (long long)i * RECORDS_PER_PAGE, PAGE_BYTES);
+        frames[f].page = firstPage + i;
+        frames[f].dirty = false;
+        // Only the requested page counts as used, prefetched pages go first
+        frames[f].referenced = (i == 0);
+        pageToFrame[firstPage + i] = f;
+    }
+    pagesRead += pages;
+    delete[] buffer;
+    return true;
+}
+
+// Return the records of a page, faulting it into the cache if needed
+StudentRecord* PagedRoster::pageRecords(long long page) {
+    int f = pageToFrame[page];
+    if (f >= 0) {
+        hits++;
+    } else {
+        misses++;
+        int pages = 1;
+        if (sequential || page == lastPage + 1) {
+            // Read ahead: extend over following pages that are not cached yet
+            int limit = PREFETCH_PAGES;
+            if (limit > frameCount / 2) limit = frameCount / 2;
+            while (pages < limit && page + pages < pageCount && pageToFrame[page + pages] < 0) {
+                pages++;
+            }
+        }
+        if (!loadPages(page, pages)) {
+            return nullptr;
+        }
+        f = pageToFrame[page];
+    }
+    frames[f].referenced = true;
+    lastPage = page;
+    return frameData + (long long)f * RECORDS_PER_PAGE;
+}
+
+// Read one student
+bool PagedRoster::getStudent(long long index, Student& out) {
+    if (index < 0 || index >= recordCount) {
+        return false;
+    }
+    StudentRecord* records = pageRecords(index / RECORDS_PER_PAGE);
+    if (records == nullptr) {
+        return false;
+    }
+    return fromRecord(records[index % RECORDS_PER_PAGE], out);
+}
+
+// Replace one student
+bool PagedRoster::putStudent(long long index, const Student& s) {
+    if (index < 0 || index >= recordCount) {
+        return false;
+    }
+    long long page = index / RECORDS_PER_PAGE;
+    StudentRecord* records = pageRecords(page);
+    if (records == nullptr) {
+        return false;
+    }
+    toRecord(s, records[index % RECORDS_PER_PAGE]);
+    frames[pageToFrame[page]].dirty = true;
+    return true;
+}
+
+// Add a student at the end of the roster
+bool PagedRoster::appendStudent(const Student& s) {
+    if (!file.is_open()) {
+        return false;
+    }
+    long long page = recordCount / RECORDS_PER_PAGE;
+    if (page >= pageCount) {
+        // Start a new page directly in the cache, nothing to read
+        int f = pickVictim();
+        if (f < 0) {
+            return false;
+        }
+        pageCount = page + 1;
+        growPageTable(pageCount);
+        memset(frameData + (long long)f * RECORDS_PER_PAGE, 0, PAGE_BYTES);
+        frames[f].page = page;
+        frames[f].referenced = true;
+        pageToFrame[page] = f;
+    }
+    recordCount++;
+    return putStudent(recordCount - 1, s);
+}
+
+// Write all dirty pages and the header to disk
+bool PagedRoster::flush() {
+    if (!file.is_open()) {
+        return false;
+    }
+    bool ok = true;
+    for (int f = 0; f < frameCount; f++) {
+        if (frames[f].page >= 0 && frames[f].dirty && !writeFrame(f)) {
+            ok = false;
+        }
+    }
+    if (!ok) {
+        // Keep the old record count so the header never covers unwritten pages
+        return false;
+    }
+    unsigned long long total = recordCount;
+    file.clear();
+    file.seekp(8);
+    file.write((const char*)&total, 8);
+    file.flush();
+    return (bool)file;
+}
+
+void PagedRoster::setSequential(bool on) {
+    sequential = on;
+}
+
+int PagedRoster::getFrameCount() const {
+    return frameCount;
+}
+
+long long PagedRoster::getCacheBytes() const {
+    return frameCount * PAGE_BYTES;
+}
+
+long long PagedRoster::getHits() const {
+    return hits;
+}
+
+long long PagedRoster::getMisses() const {
+    return misses;
+}
+
+long long PagedRoster::getPagesRead() const {
+    return pagesRead;
+}
+
+long long PagedRoster::getPagesWritten() const {
+    return pagesWritten;
+}
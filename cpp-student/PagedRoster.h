@@ -0,0 +1,108 @@
+// PagedRoster.h - Disk-backed roster with a bounded page cache
+#ifndef PAGEDROSTER_H
+#define PAGEDROSTER_H
+
+#include "Student.h"
+#include <fstream>
+
+// Fixed-size on-disk record for one student
+struct StudentRecord {
+    char studentId[10];          // 10 digits, no terminator
+    char name[8];                // padded with '\0'
+    unsigned char age;
+    char gender;
+    unsigned char courseCount;
+    unsigned char reserved;
+    double scores[5];
+    double avgScore;
+};
+
+// Number of records stored in one page
+const int RECORDS_PER_PAGE = 64;
+
+// Pages read with one request when a sequential scan misses the cache
+const int PREFETCH_PAGES = 8;
+
+// Convert between Student objects and records. fromRecord() returns false
+// and leaves the student unchanged if the record fails isValidRecord().
+void toRecord(const Student& s, StudentRecord& rec);
+bool fromRecord(const StudentRecord& rec, Student& s);
+
+// Check a record read from a file: 10-digit ID, name of 1-8 characters,
+// age 1-150, gender M or F, 3 or 5 courses and scores in 0-100
+bool isValidRecord(const StudentRecord& rec);
+
+class PagedRoster {
+private:
+    // One cache frame holds one page of records
+    struct Frame {
+        long long page;          // page number, -1 if empty
+        bool dirty;              // page changed since it was read
+        bool referenced;         // CLOCK reference bit
+    };
+
+    fstream file;
+    long long recordCount;       // students in the roster
+    long long pageCount;         // pages in the file
+    int frameCount;              // cache size in pages
+    Frame* frames;
+    StudentRecord* frameData;    // frameCount * RECORDS_PER_PAGE records
+    int* pageToFrame;            // page number -> frame, -1 if not cached
+    long long pageTableSize;
+    int clockHand;
+    long long lastPage;          // last page accessed (for sequential detection)
+    bool sequential;             // read-ahead enabled
+
+    long long hits;
+    long long misses;
+    long long pagesRead;
+    long long pagesWritten;
+
+    // Not copyable
+    PagedRoster(const PagedRoster& other);
+    PagedRoster& operator=(const PagedRoster& other);
+
+    bool setupCache(long long cacheBytes);
+    void growPageTable(long long pages);
+    int pickVictim();
+    bool writeFrame(int f);
+    bool loadPages(long long firstPage, int pages);
+    StudentRecord* pageRecords(long long page);
+
+public:
+    PagedRoster();
+    ~PagedRoster();
+
+    // Create a page file from an in-memory roster
+    bool create(const string& fileName, const Student* const* list, int count, long long cacheBytes);
+
+    // Open an existing page file
+    bool open(const string& fileName, long long cacheBytes);
+
+    // Write dirty pages and close the file
+    void close();
+
+    bool isOpen() const;
+    long long size() const;
+
+    // Access students by position
+    bool getStudent(long long index, Student& out);
+    bool putStudent(long long index, const Student& s);
+    bool appendStudent(const Student& s);
+
+    // Write all dirty pages to disk
+    bool flush();
+
+    // Enable or disable read-ahead for sequential scans
+    void setSequential(bool on);
+
+    // Cache statistics
+    int getFrameCount() const;
+    long long getCacheBytes() const;
+    long long getHits() const;
+    long long getMisses() const;
+    long long getPagesRead() const;
+    long long getPagesWritten() const;
+};
+
+#endif // PAGEDROSTER_H
@@ -0,0 +1,371 @@
+// Roster.cpp - Student roster with removal, stable handles and compaction
+#include "Roster.h"
+#include "StudentT.h"
+#include <chrono>
+
+// Constructor
+Roster::Roster() {
+    students = nullptr;
+    removed = nullptr;
+    slotHandle = nullptr;
+    slotCount = 0;
+    capacity = 0;
+    liveCount = 0;
+    handleSlot = nullptr;
+    generations = nullptr;
+    freeHandles = nullptr;
+    freeHandleCount = 0;
+    handleCount = 0;
+    handleCapacity = 0;
+    compacting = false;
+    writePos = 0;
+    readPos = 0;
+    movedTotal = 0;
+    changeCount = 0;
+}
+
+// Destructor
+Roster::~Roster() {
+    clear();
+}
+
+// Remove all students and release memory
+void Roster::clear() {
+    delete[] students;
+    delete[] removed;
+    delete[] slotHandle;
+    delete[] handleSlot;
+    delete[] generations;
+    delete[] freeHandles;
+    students = nullptr;
+    removed = nullptr;
+    slotHandle = nullptr;
+    handleSlot = nullptr;
+    generations = nullptr;
+    freeHandles = nullptr;
+    slotCount = 0;
+    capacity = 0;
+    liveCount = 0;
+    changeCount++;
+    freeHandleCount = 0;
+    handleCount = 0;
+    handleCapacity = 0;
+    compacting = false;
+    idIndex.clear();
+}
+
+// Reserve space for n students
+void Roster::reserve(int n) {
+    // Grow straight to the final size (a bulk load reserves millions)
+    if (capacity < n) {
+        growSlots(n);
+    }
+    if (handleCapacity < n) {
+        growHandles(n);
+    }
+    idIndex.reserve(n);
+}
+
+// Grow the slot arrays to at least minCapacity (at least doubling)
+void Roster::growSlots(int minCapacity) {
+    int newCapacity = capacity > 0 ? capacity * 2 : 16;
+    if (newCapacity < minCapacity) {
+        newCapacity = minCapacity;
+    }
+    Student* newStudents = new Student[newCapacity];
+    bool* newRemoved = new bool[newCapacity];
+    int* newSlotHandle = new int[newCapacity];
+    for (int i = 0; i < slotCount; i++) {
+        newStudents[i] = students[i];
+        newRemoved[i] = removed[i];
+        newSlotHandle[i] = slotHandle[i];
+    }
+    delete[] students;
+    delete[] removed;
+    delete[] slotHandle;
+    students = newStudents;
+    removed = newRemoved;
+    slotHandle = newSlotHandle;
+    capacity = newCapacity;
+}
+
+// Grow the handle arrays to at least minCapacity (at least doubling)
+void Roster::growHandles(int minCapacity) {
+    int newCapacity = handleCapacity > 0 ? handleCapacity * 2 : 16;
+    if (newCapacity < minCapacity) {
+        newCapacity = minCapacity;
+    }
+    int* newHandleSlot = new int[newCapacity];
+    unsigned int* newGenerations = new unsigned int[newCapacity];
+    int* newFreeHandles = new int[newCapacity];
+    for (int i = 0; i < handleCount; i++) {
+        newHandleSlot[i] = handleSlot[i];
+        newGenerations[i] = generations[i];
+    }
+    for (int i = 0; i < freeHandleCount; i++) {
+        newFreeHandles[i] = freeHandles[i];
+    }
+    delete[] handleSlot;
+    delete[] generations;
+    delete[] freeHandles;
+    handleSlot = newHandleSlot;
+    generations = newGenerations;
+    freeHandles = newFreeHandles;
+    handleCapacity = newCapacity;
+}
+
+// Add a student at the end
+StudentHandle Roster::add(const Student& s) {
+    if (slotCount == capacity) {
+        growSlots(0);
+    }
+
+    int h;
+    if (freeHandleCount > 0) {
+        h = freeHandles[--freeHandleCount];
+    } else {
+        if (handleCount == handleCapacity) {
+            growHandles(0);
+        }
+        h = handleCount++;
+        generations[h] = 0;
+    }
+
+    int slot = slotCount++;
+    students[slot] = s;
+    removed[slot] = false;
+    slotHandle[slot] = h;
+    handleSlot[h] = slot;
+    liveCount++;
+    changeCount++;
+    idIndex.insert(packStudentId(s.getStudentId()), slot);
+
+    StudentHandle handle;
+    handle.index = h;
+    handle.generation = generations[h];
+    return handle;
+}
+
+int Roster::getSlotCount() const {
+    return slotCount;
+}
+
+int Roster::size() const {
+    return liveCount;
+}
+
+bool Roster::isLive(int slot) const {
+    return slot >= 0 && slot < slotCount && !removed[slot];
+}
+
+Student& Roster::at(int slot) {
+    return students[slot];
+}
+
+const Student& Roster::at(int slot) const {
+    return students[slot];
+}
+
+StudentHandle Roster::handleOf(int slot) const {
+    StudentHandle handle;
+    handle.index = slotHandle[slot];
+    handle.generation = generations[handle.index];
+    return handle;
+}
+
+// Find the current slot of a handle, false if the student was removed
+bool Roster::resolve(const StudentHandle& h, int& slot) const {
+    if (h.index < 0 || h.index >= handleCount
+        || generations[h.index] != h.generation || handleSlot[h.index] < 0) {
+        return false;
+    }
+    slot = handleSlot[h.index];
+    return true;
+}
+
+// Slot of a student ID, -1 if not found
+int Roster::findById(const string& id) const {
+    if (!isValidId(id)) {
+        return -1;
+    }
+    int slot;
+    if (idIndex.find(packStudentId(id), slot)) {
+        return slot;
+    }
+    return -1;
+}
+
+// Slot of a packed student ID, -1 if not found (safe to call from several threads)
+int Roster::findByPackedId(unsigned long long id) const {
+    int slot;
+    if (idIndex.find(id, slot)) {
+        return slot;
+    }
+    return -1;
+}
+
+// Update the ID index after the student in a slot changed its ID
+void Roster::updateIdIndex(int slot, const string& oldId) {
+    unsigned long long oldKey = packStudentId(oldId);
+    int indexed;
+    if (idIndex.find(oldKey, indexed) && indexed == slot) {
+        idIndex.erase(oldKey);
+    }
+    idIndex.insert(packStudentId(students[slot].getStudentId()), slot);
+}
+
+// Remove a student (leaves a tombstone)
+bool Roster::remove(int slot) {
+    if (!isLive(slot)) {
+        return false;
+    }
+    idIndex.erase(packStudentId(students[slot].getStudentId()));
+
+    // Free the handle, older copies of it become stale
+    int h = slotHandle[slot];
+    handleSlot[h] = -1;
+    generations[h]++;
+    freeHandles[freeHandleCount++] = h;
+
+    removed[slot] = true;
+    students[slot] = Student();
+    liveCount--;
+    changeCount++;
+
+    // Compaction restarts from the first hole
+    if (!compacting || slot < writePos) {
+        compacting = true;
+        writePos = slot;
+        readPos = slot + 1;
+    }
+    return true;
+}
+
+bool Roster::remove(const StudentHandle& h) {
+    int slot;
+    if (!resolve(h, slot)) {
+        return false;
+    }
+    return remove(slot);
+}
+
+// Move a live student to a lower free slot and update its references
+void Roster::moveSlot(int from, int to) {
+    students[to] = students[from];
+    students[from] = Student();
+    removed[to] = false;
+    removed[from] = true;
+    int h = slotHandle[from];
+    slotHandle[to] = h;
+    handleSlot[h] = to;
+    idIndex.insert(packStudentId(students[to].getStudentId()), to);
+    movedTotal++;
+}
+
+bool Roster::isCompacting() const {
+    return compacting;
+}
+
+// Move students until the time budget is used
+int Roster::compactStep(long long budgetMicros) {
+    if (!compacting) {
+        return 0;
+    }
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    int moved = 0;
+    int examined = 0;
+    while (readPos < slotCount) {
+        if (!removed[readPos]) {
+            moveSlot(readPos, writePos);
+            writePos++;
+            moved++;
+        }
+        readPos++;
+        examined++;
+        // Check the clock every 64 slots
+        if (budgetMicros >= 0 && examined % 64 == 0) {
+            long long used = chrono::duration_cast<chrono::microseconds>(
+                chrono::steady_clock::now() - start).count();
+            if (used >= budgetMicros) {
+                return moved;
+            }
+        }
+    }
+    slotCount = writePos;
+    compacting = false;
+    return moved;
+}
+
+// Recompute every average in bulk from a column copy of the scores
+void Roster::recomputeAverages(ScoreColumns& columns) {
+    Student** list = new Student*[liveCount > 0 ? liveCount : 1];
+    int n = 0;
+    for (int i = 0; i < slotCount; i++) {
+        if (!removed[i]) {
+            list[n++] = &students[i];
+        }
+    }
+    columns.build(list, n);
+    columns.recomputeAverages();
+    columns.writeAverages(list);
+    delete[] list;
+}
+
+unsigned long long Roster::getVersion() const {
+    return changeCount + studentEditCount();
+}
+
+long long Roster::getMovedTotal() const {
+    return movedTotal;
+}
+
+long long Roster::indexMemoryBytes() const {
+    return idIndex.memoryBytes();
+}
+
+// Bytes per component, including unused capacity
+void Roster::memoryUsage(RosterMemory& usage) const {
+    usage.studentObjects = (long long)capacity * sizeof(Student);
+    usage.stringHeap = 0;
+    usage.scoreArrays = 0;
+    for (int i = 0; i < slotCount; i++) {
+        usage.stringHeap += students[i].stringHeapBytes();
+        usage.scoreArrays += students[i].scoreHeapBytes();
+    }
+    usage.slotTables = (long long)capacity * (sizeof(bool) + sizeof(int));
+    usage.handleTables = (long long)handleCapacity * (sizeof(int) + sizeof(unsigned int) + sizeof(int));
+    usage.idIndex = idIndex.memoryBytes();
+    usage.total = usage.studentObjects + usage.stringHeap + usage.scoreArrays
+                + usage.slotTables + usage.handleTables + usage.idIndex;
+}
+
+int Roster::getCapacity() const {
+    return capacity;
+}
+
+// Collect the live students in slot order
+RosterView::RosterView(const Roster& roster) {
+    list = new const Student*[roster.size() > 0 ? roster.size() : 1];
+    count = 0;
+    for (int i = 0; i < roster.getSlotCount(); i++) {
+        if (roster.isLive(i)) {
+            list[count++] = &roster.at(i);
+        }
+    }
+}
+
+RosterView::~RosterView() {
+    delete[] list;
+}
+
+const Student* const* RosterView::data() const {
+    return list;
+}
+
+int RosterView::size() const {
+    return count;
+}
+
+const Student& RosterView::at(int index) const {
+    return *list[index];
+}
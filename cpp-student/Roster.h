@@ -0,0 +1,143 @@
+// Roster.h - Student roster with removal, stable handles and compaction
+#ifndef ROSTER_H
+#define ROSTER_H
+
+#include "Student.h"
+#include "IdIndex.h"
+
+class ScoreColumns;
+
+// Stable reference to a student. It stays valid while the student is moved
+// by compaction, and becomes stale (detected) once the student is removed.
+struct StudentHandle {
+    int index;                   // entry in the handle table
+    unsigned int generation;     // must match the table entry
+};
+
+// Bytes used by each part of a roster
+struct RosterMemory {
+    long long studentObjects;    // sizeof(Student) for every slot, used or not
+    long long stringHeap;        // IDs and names too long for the string buffer
+    long long scoreArrays;       // per-student score arrays
+    long long slotTables;        // tombstone flags and slot -> handle
+    long long handleTables;      // handle -> slot, generations, free list
+    long long idIndex;           // ID index arrays and hash
+    long long total;
+};
+
+// Students live in slots. Removing a student leaves a tombstone; compaction
+// later slides live students down (keeping their order) in small steps and
+// updates the handle table and ID index for every moved student.
+class Roster {
+private:
+    Student* students;
+    bool* removed;               // tombstone flags
+    int* slotHandle;             // slot -> handle index
+    int slotCount;               // live students and tombstones
+    int capacity;
+    int liveCount;
+
+    int* handleSlot;             // handle index -> slot, -1 if free
+    unsigned int* generations;   // bumped when a handle is freed
+    int* freeHandles;
+    int freeHandleCount;
+    int handleCount;
+    int handleCapacity;
+
+    IdIndex idIndex;             // packed ID -> slot
+
+    bool compacting;
+    int writePos;                // next slot to fill
+    int readPos;                 // next slot to examine
+    long long movedTotal;
+    unsigned long long changeCount;  // students added or removed
+
+    // Not copyable
+    Roster(const Roster& other);
+    Roster& operator=(const Roster& other);
+
+    void growSlots(int minCapacity);
+    void growHandles(int minCapacity);
+    void moveSlot(int from, int to);
+
+public:
+    Roster();
+    ~Roster();
+
+    // Remove all students and release memory
+    void clear();
+
+    // Reserve space for n students
+    void reserve(int n);
+
+    // Add a student at the end (the caller checks for duplicate IDs)
+    StudentHandle add(const Student& s);
+
+    // Slots, including tombstones, and live students
+    int getSlotCount() const;
+    int size() const;
+    bool isLive(int slot) const;
+    Student& at(int slot);
+    const Student& at(int slot) const;
+
+    // Handles
+    StudentHandle handleOf(int slot) const;
+    bool resolve(const StudentHandle& h, int& slot) const;
+
+    // Slot of a student ID, -1 if not found
+    int findById(const string& id) const;
+    int findByPackedId(unsigned long long id) const;
+
+    // Update the ID index after the student in a slot changed its ID
+    void updateIdIndex(int slot, const string& oldId);
+
+    // Remove a student (leaves a tombstone)
+    bool remove(int slot);
+    bool remove(const StudentHandle& h);
+
+    // Incremental compaction: move students until the time budget is used,
+    // returns the number of students moved
+    bool isCompacting() const;
+    int compactStep(long long budgetMicros);
+
+    // Recompute every average in bulk from a column copy of the scores
+    // (live slots in place, compaction is not finished first). The columns
+    // are left filled, positions in the order of a RosterView, for further
+    // bulk queries.
+    void recomputeAverages(ScoreColumns& columns);
+
+    // Changes since the roster was created: students added or removed, and
+    // ID, score or course count changes through the Student setters. A copy
+    // made at one version is stale once the version differs.
+    unsigned long long getVersion() const;
+
+    long long getMovedTotal() const;
+    long long indexMemoryBytes() const;
+
+    // Bytes per component, including unused capacity
+    void memoryUsage(RosterMemory& usage) const;
+    int getCapacity() const;
+};
+
+// Pointers to the live students of a roster in slot order. Nothing is
+// moved, so bulk readers do not wait for a pending compaction. Valid until
+// the roster is changed.
+class RosterView {
+private:
+    const Student** list;
+    int count;
+
+    // Not copyable
+    RosterView(const RosterView& other);
+    RosterView& operator=(const RosterView& other);
+
+public:
+    RosterView(const Roster& roster);
+    ~RosterView();
+
+    const Student* const* data() const;
+    int size() const;
+    const Student& at(int index) const;
+};
+
+#endif // ROSTER_H
@@ -0,0 +1,422 @@
+// ScoreJoin.cpp - Reconcile external score feeds with the roster (hash join)
+#include "ScoreJoin.h"
+#include "Enrollment.h"
+#include "Validate.h"
+#include <fstream>
+#include <algorithm>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+
+// Below this many probes per thread the join runs on the calling thread
+const long long MIN_ROWS_PER_THREAD = 65536;
+
+// Feed scores are range checked in column batches of this size (a multiple
+// of 64, so every batch starts on a bitmap word)
+const long long SCORE_CHECK_ROWS = 1 << 20;
+
+// Constructor
+ScoreFeed::ScoreFeed() {
+    capacity = 1024;
+    count = 0;
+    badRows = 0;
+    ids = new unsigned long long[capacity];
+    courseIds = new int[capacity];
+    scores = new double[capacity];
+    scoreErrors = new unsigned long long[errorBitmapWords((int)capacity)];
+}
+
+// Destructor
+ScoreFeed::~ScoreFeed() {
+    delete[] ids;
+    delete[] courseIds;
+    delete[] scores;
+    delete[] scoreErrors;
+}
+
+// Double the row arrays
+void ScoreFeed::grow() {
+    long long newCapacity = capacity * 2;
+    unsigned long long* newIds = new unsigned long long[newCapacity];
+    int* newCourseIds = new int[newCapacity];
+    double* newScores = new double[newCapacity];
+    unsigned long long* newErrors = new unsigned long long[newCapacity / 64];
+    memcpy(newIds, ids, count * sizeof(unsigned long long));
+    memcpy(newCourseIds, courseIds, count * sizeof(int));
+    memcpy(newScores, scores, count * sizeof(double));
+    memcpy(newErrors, scoreErrors, capacity / 64 * sizeof(unsigned long long));
+    delete[] ids;
+    delete[] courseIds;
+    delete[] scores;
+    delete[] scoreErrors;
+    ids = newIds;
+    courseIds = newCourseIds;
+    scores = newScores;
+    scoreErrors = newErrors;
+    capacity = newCapacity;
+}
+
+// Store a row, its score is checked later by validateScores()
+void ScoreFeed::appendRow(unsigned long long id, int courseId, double score) {
+    if (count == capacity) {
+        grow();
+    }
+    ids[count] = id;
+    courseIds[count] = courseId;
+    scores[count] = score;
+    count++;
+}
+
+// Range check the scores of rows [first, count) with the column validator.
+// Checking starts at the bitmap word holding row first.
+void ScoreFeed::validateScores(long long first) {
+    long long start = first / 64 * 64;
+    while (start < count) {
+        int rows = (int)min(count - start, SCORE_CHECK_ROWS);
+        clearErrorBitmap(scoreErrors + start / 64, rows);
+        validateScoreColumn(scores + start, rows, scoreErrors + start / 64);
+        start += rows;
+    }
+}
+
+void ScoreFeed::addRow(unsigned long long id, int courseId, double score) {
+    appendRow(id, courseId, score);
+    validateScores(count - 1);
+}
+
+static bool isFieldSeparator(char c) {
+    return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+// Skip separators, returns the start of the next field (or lineEnd)
+static const char* nextField(const char* p, const char* lineEnd) {
+    while (p < lineEnd && isFieldSeparator(*p)) {
+        p++;
+    }
+    return p;
+}
+
+// Read a feed file, false if it cannot be opened
+bool ScoreFeed::load(const string& fileName) {
+    ifstream file(fileName.c_str(), ios::binary);
+    if (!file) {
+        return false;
+    }
+    // Read the whole file at once, then parse it in place
+    file.seekg(0, ios::end);
+    long long size = (long long)file.tellg();
+    file.seekg(0, ios::beg);
+    if (size < 0) {
+        return false;
+    }
+    string data((size_t)size, '\0');
+    file.read(&data[0], size);
+
+    count = 0;
+    badRows = 0;
+    const char* p = data.c_str();
+    const char* end = p + data.size();
+    while (p < end) {
+        const char* lineEnd = (const char*)memchr(p, '\n', end - p);
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+
+        const char* field = nextField(p, lineEnd);
+        p = lineEnd + 1;
+        if (field == lineEnd) {
+            continue;   // empty line
+        }
+
+        // Student ID: exactly 10 digits
+        const char* idEnd = field;
+        while (idEnd < lineEnd && !isFieldSeparator(*idEnd)) {
+            idEnd++;
+        }
+        unsigned long long id;
+        if (idEnd - field != 10 || !parseId10(field, id)) {
+            badRows++;
+            continue;
+        }
+
+        // Course ID and score (strtol/strtod would skip over a line break,
+        // so the field start is checked first)
+        field = nextField(idEnd, lineEnd);
+        if (field == lineEnd || *field < '0' || *field > '9') {
+            badRows++;
+            continue;
+        }
+        char* numberEnd;
+        long courseId = strtol(field, &numberEnd, 10);
+        field = nextField(numberEnd, lineEnd);
+        if (field == lineEnd || !(*field == '-' || *field == '.' || (*field >= '0' && *field <= '9'))) {
+            badRows++;
+            continue;
+        }
+        double score = strtod(field, &numberEnd);
+        if (numberEnd > lineEnd || nextField(numberEnd, lineEnd) != lineEnd) {
+            badRows++;
+            continue;
+        }
+        appendRow(id, (int)courseId, score);
+    }
+    validateScores(0);
+    return true;
+}
+
+long long ScoreFeed::getCount() const {
+    return count;
+}
+
+long long ScoreFeed::getBadRows() const {
+    return badRows;
+}
+
+unsigned long long ScoreFeed::getId(long long row) const {
+    return ids[row];
+}
+
+int ScoreFeed::getCourseId(long long row) const {
+    return courseIds[row];
+}
+
+double ScoreFeed::getScore(long long row) const {
+    return scores[row];
+}
+
+bool ScoreFeed::isScoreValid(long long row) const {
+    return !rowHasError(scoreErrors + row / 64, (int)(row % 64));
+}
+
+// Constructor
+ScoreJoinResult::ScoreJoinResult() {
+    rows = nullptr;
+    count = 0;
+    matches = 0;
+    orphans = 0;
+    conflicts = 0;
+    builtOnFeed = false;
+    threadsUsed = 0;
+}
+
+// Destructor
+ScoreJoinResult::~ScoreJoinResult() {
+    delete[] rows;
+}
+
+// Decide the outcome of a feed row whose student was found
+static void classifyRow(const Student& s, int slot, const ScoreFeed& feed,
+                        long long row, JoinRow& out) {
+    int courseCount = s.getCourseCount();
+    int base = courseCount == 5 ? TYPE1_COURSE_BASE : TYPE2_COURSE_BASE;
+    int course = feed.getCourseId(row) - base - 1;
+    out.slot = slot;
+    if (course < 0 || course >= courseCount) {
+        out.course = -1;
+        out.outcome = JOIN_CONFLICT;
+        out.reason = CONFLICT_COURSE;
+        return;
+    }
+    out.course = (signed char)course;
+    if (!feed.isScoreValid(row)) {
+        out.outcome = JOIN_CONFLICT;
+        out.reason = CONFLICT_SCORE;
+        return;
+    }
+    out.outcome = JOIN_MATCH;
+    out.reason = CONFLICT_NONE;
+}
+
+// Feed rows [begin, end) probe the roster's ID index
+static void probeRosterIndex(const Roster* roster, const ScoreFeed* feed,
+                             JoinRow* rows, long long begin, long long end) {
+    for (long long i = begin; i < end; i++) {
+        int slot = roster->findByPackedId(feed->getId(i));
+        if (slot >= 0) {
+            classifyRow(roster->at(slot), slot, *feed, i, rows[i]);
+        }
+    }
+}
+
+// Roster slots [begin, end) probe the hash table built on the feed.
+// Roster IDs are unique, so each feed row is written by one thread only.
+static void probeFeedIndex(const Roster* roster, const ScoreFeed* feed,
+                           const IdHash* feedIndex, const int* nextRow,
+                           JoinRow* rows, int begin, int end) {
+    for (int slot = begin; slot < end; slot++) {
+        if (!roster->isLive(slot)) {
+            continue;
+        }
+        const Student& s = roster->at(slot);
+        int row;
+        if (!feedIndex->find(packStudentId(s.getStudentId()), row)) {
+            continue;
+        }
+        for (; row >= 0; row = nextRow[row]) {
+            classifyRow(s, slot, *feed, row, rows[row]);
+        }
+    }
+}
+
+// Matches that repeat a (student, course) pair with different scores
+// become conflicts; identical repeats stay matched
+static void markDuplicates(const ScoreFeed& feed, JoinRow* rows, long long n) {
+    long long matchCount = 0;
+    for (long long i = 0; i < n; i++) {
+        if (rows[i].outcome == JOIN_MATCH) {
+            matchCount++;
+        }
+    }
+    long long* order = new long long[matchCount];
+    long long k = 0;
+    for (long long i = 0; i < n; i++) {
+        if (rows[i].outcome == JOIN_MATCH) {
+            order[k++] = i;
+        }
+    }
+    sort(order, order + matchCount, [rows](long long a, long long b) {
+        if (rows[a].slot != rows[b].slot) {
+            return rows[a].slot < rows[b].slot;
+        }
+        if (rows[a].course != rows[b].course) {
+            return rows[a].course < rows[b].course;
+        }
+        return a < b;
+    });
+
+    long long start = 0;
+    while (start < matchCount) {
+        long long stop = start + 1;
+        bool differs = false;
+        while (stop < matchCount && rows[order[stop]].slot == rows[order[start]].slot
+               && rows[order[stop]].course == rows[order[start]].course) {
+            if (feed.getScore(order[stop]) != feed.getScore(order[start])) {
+                differs = true;
+            }
+            stop++;
+        }
+        if (differs) {
+            for (long long j = start; j < stop; j++) {
+                rows[order[j]].outcome = JOIN_CONFLICT;
+                rows[order[j]].reason = CONFLICT_DUPLICATE;
+            }
+        }
+        start = stop;
+    }
+    delete[] order;
+}
+
+// Join a feed against the roster
+void joinScoreFeed(const Roster& roster, const ScoreFeed& feed,
+                   int threadCount, ScoreJoinResult& result) {
+    long long n = feed.getCount();
+    delete[] result.rows;
+    result.rows = new JoinRow[n > 0 ? n : 1];
+    result.count = n;
+    JoinRow* rows = result.rows;
+    for (long long i = 0; i < n; i++) {
+        rows[i].slot = -1;
+        rows[i].course = -1;
+        rows[i].outcome = JOIN_ORPHAN;
+        rows[i].reason = CONFLICT_NONE;
+    }
+
+    // The probe side is split over the threads
+    result.builtOnFeed = n < roster.size();
+    long long probeCount = result.builtOnFeed ? roster.getSlotCount() : n;
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+    long long useful = probeCount / MIN_ROWS_PER_THREAD;
+    if (useful < threadCount) {
+        threadCount = useful > 1 ? (int)useful : 1;
+    }
+    result.threadsUsed = threadCount;
+
+    IdHash feedIndex;
+    int* nextRow = nullptr;
+    if (result.builtOnFeed) {
+        // Chain rows with the same ID; inserting backwards keeps each chain
+        // in file order
+        feedIndex.reserve(n);
+        nextRow = new int[n > 0 ? n : 1];
+        for (long long i = n - 1; i >= 0; i--) {
+            int head;
+            nextRow[i] = feedIndex.find(feed.getId(i), head) ? head : -1;
+            feedIndex.insert(feed.getId(i), (int)i);
+        }
+    }
+
+    thread* workers = new thread[threadCount];
+    long long chunk = (probeCount + threadCount - 1) / threadCount;
+    for (int t = 0; t < threadCount; t++) {
+        long long begin = t * chunk < probeCount ? t * chunk : probeCount;
+        long long end = begin + chunk < probeCount ? begin + chunk : probeCount;
+        if (result.builtOnFeed) {
+            if (t == threadCount - 1) {
+                probeFeedIndex(&roster, &feed, &feedIndex, nextRow, rows, (int)begin, (int)end);
+            } else {
+                workers[t] = thread(probeFeedIndex, &roster, &feed, &feedIndex, nextRow,
+                                    rows, (int)begin, (int)end);
+            }
+        } else {
+            if (t == threadCount - 1) {
+                probeRosterIndex(&roster, &feed, rows, begin, end);
+            } else {
+                workers[t] = thread(probeRosterIndex, &roster, &feed, rows, begin, end);
+            }
+        }
+    }
+    for (int t = 0; t < threadCount - 1; t++) {
+        workers[t].join();
+    }
+    delete[] workers;
+    delete[] nextRow;
+
+    markDuplicates(feed, rows, n);
+
+    result.matches = 0;
+    result.orphans = 0;
+    result.conflicts = 0;
+    for (long long i = 0; i < n; i++) {
+        if (rows[i].outcome == JOIN_MATCH) {
+            result.matches++;
+        } else if (rows[i].outcome == JOIN_ORPHAN) {
+            result.orphans++;
+        } else {
+            result.conflicts++;
+        }
+    }
+}
+
+// Apply the matched rows with setScore and recompute averages
+long long applyScoreMatches(Roster& roster, const ScoreFeed& feed,
+                            const ScoreJoinResult& result) {
+    long long changed = 0;
+    for (long long i = 0; i < result.count; i++) {
+        const JoinRow& r = result.rows[i];
+        if (r.outcome != JOIN_MATCH) {
+            continue;
+        }
+        Student& s = roster.at(r.slot);
+        if (s.getScore(r.course) != feed.getScore(i) && s.setScore(r.course, feed.getScore(i))) {
+            s.calcAverage();
+            changed++;
+        }
+    }
+    return changed;
+}
+
+// Text for a conflict reason
+string conflictReasonText(int reason) {
+    switch (reason) {
+        case CONFLICT_COURSE:
+            return "course not taken by this student";
+        case CONFLICT_SCORE:
+            return "score out of range";
+        case CONFLICT_DUPLICATE:
+            return "repeated with a different score";
+        default:
+            return "";
+    }
+}
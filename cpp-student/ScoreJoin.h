@@ -0,0 +1,104 @@
+// ScoreJoin.h - Reconcile external score feeds with the roster (hash join)
+#ifndef SCOREJOIN_H
+#define SCOREJOIN_H
+
+#include "Roster.h"
+
+// Outcome of one feed row
+enum JoinOutcome {
+    JOIN_MATCH = 1,      // known student and course, score can be applied
+    JOIN_ORPHAN,         // student ID not in the roster
+    JOIN_CONFLICT        // see ConflictReason
+};
+
+enum ConflictReason {
+    CONFLICT_NONE = 0,
+    CONFLICT_COURSE,     // course not taken by this student type
+    CONFLICT_SCORE,      // score outside 0-100
+    CONFLICT_DUPLICATE   // same student and course repeated with different scores
+};
+
+// Rows of a score feed file: "studentId courseId score" per line, fields
+// separated by spaces, tabs or commas. Course IDs are catalog IDs
+// (101-105 for 5-course students, 201-203 for 3-course students).
+class ScoreFeed {
+private:
+    unsigned long long* ids;     // packed student IDs
+    int* courseIds;
+    double* scores;
+    unsigned long long* scoreErrors; // one bit per row, set for scores outside 0-100
+    long long count;
+    long long capacity;
+    long long badRows;           // lines that could not be parsed
+
+    // Not copyable
+    ScoreFeed(const ScoreFeed& other);
+    ScoreFeed& operator=(const ScoreFeed& other);
+
+    void grow();
+    void appendRow(unsigned long long id, int courseId, double score);
+    void validateScores(long long first);
+
+public:
+    ScoreFeed();
+    ~ScoreFeed();
+
+    // Read a feed file, false if it cannot be opened
+    bool load(const string& fileName);
+
+    // Add one row
+    void addRow(unsigned long long id, int courseId, double score);
+
+    long long getCount() const;
+    long long getBadRows() const;
+    unsigned long long getId(long long row) const;
+    int getCourseId(long long row) const;
+    double getScore(long long row) const;
+
+    // Score range check result (from validateScoreColumn)
+    bool isScoreValid(long long row) const;
+};
+
+// Result for one feed row (rows[i] belongs to feed row i)
+struct JoinRow {
+    int slot;                    // roster slot, -1 for orphans
+    signed char course;          // course index in the student, -1 if none
+    unsigned char outcome;       // JoinOutcome
+    unsigned char reason;        // ConflictReason
+};
+
+// Output of a join
+class ScoreJoinResult {
+private:
+    // Not copyable
+    ScoreJoinResult(const ScoreJoinResult& other);
+    ScoreJoinResult& operator=(const ScoreJoinResult& other);
+
+public:
+    JoinRow* rows;
+    long long count;
+    long long matches;
+    long long orphans;
+    long long conflicts;
+    bool builtOnFeed;            // true if the hash table was built on the feed
+    int threadsUsed;
+
+    ScoreJoinResult();
+    ~ScoreJoinResult();
+};
+
+// Join a feed against the roster. The hash table is built on the smaller
+// side (the roster's own ID index serves as the roster side) and probed by
+// the other side in parallel. The roster must not change during the call.
+void joinScoreFeed(const Roster& roster, const ScoreFeed& feed,
+                   int threadCount, ScoreJoinResult& result);
+
+// Apply the matched rows with setScore and recompute averages,
+// returns the number of scores that changed
+long long applyScoreMatches(Roster& roster, const ScoreFeed& feed,
+                            const ScoreJoinResult& result);
+
+// Text for a conflict reason
+string conflictReasonText(int reason);
+
+#endif // SCOREJOIN_H
@@ -0,0 +1,145 @@
+// Sha256.cpp - SHA-256 message digest (FIPS 180-4)
+#include "Sha256.h"
+#include <cstring>
+
+// Round constants: first 32 bits of the fractional parts of the cube roots
+// of the first 64 primes
+static const unsigned int ROUND_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline unsigned int rotateRight(unsigned int x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+// Constructor
+Sha256::Sha256() {
+    reset();
+}
+
+// Start a new digest with the initial hash values
+void Sha256::reset() {
+    state[0] = 0x6a09e667;
+    state[1] = 0xbb67ae85;
+    state[2] = 0x3c6ef372;
+    state[3] = 0xa54ff53a;
+    state[4] = 0x510e527f;
+    state[5] = 0x9b05688c;
+    state[6] = 0x1f83d9ab;
+    state[7] = 0x5be0cd19;
+    bufferLength = 0;
+    totalLength = 0;
+}
+
+// Process one 64-byte block
+void Sha256::compress(const unsigned char* block) {
+    unsigned int w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((unsigned int)block[i * 4] << 24) | ((unsigned int)block[i * 4 + 1] << 16)
+             | ((unsigned int)block[i * 4 + 2] << 8) | (unsigned int)block[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        unsigned int s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        unsigned int s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    unsigned int a = state[0];
+    unsigned int b = state[1];
+    unsigned int c = state[2];
+    unsigned int d = state[3];
+    unsigned int e = state[4];
+    unsigned int f = state[5];
+    unsigned int g = state[6];
+    unsigned int h = state[7];
+    for (int i = 0; i < 64; i++) {
+        unsigned int s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+        unsigned int choose = (e & f) ^ (~e & g);
+        unsigned int t1 = h + s1 + choose + ROUND_K[i] + w[i];
+        unsigned int s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+        unsigned int majority = (a & b) ^ (a & c) ^ (b & c);
+        unsigned int t2 = s0 + majority;
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+void Sha256::update(const void* data, size_t length) {
+    const unsigned char* p = (const unsigned char*)data;
+    totalLength += length;
+    // Fill a partial block first
+    if (bufferLength > 0) {
+        size_t n = 64 - bufferLength;
+        if (n > length) {
+            n = length;
+        }
+        memcpy(buffer + bufferLength, p, n);
+        bufferLength += (int)n;
+        p += n;
+        length -= n;
+        if (bufferLength < 64) {
+            return;
+        }
+        compress(buffer);
+        bufferLength = 0;
+    }
+    while (length >= 64) {
+        compress(p);
+        p += 64;
+        length -= 64;
+    }
+    memcpy(buffer, p, length);
+    bufferLength = (int)length;
+}
+
+// Pad with 0x80, zeros and the bit length, then write the digest
+void Sha256::final(unsigned char digest[SHA256_BYTES]) {
+    unsigned long long bitLength = totalLength * 8;
+    buffer[bufferLength++] = 0x80;
+    if (bufferLength > 56) {
+        memset(buffer + bufferLength, 0, 64 - bufferLength);
+        compress(buffer);
+        bufferLength = 0;
+    }
+    memset(buffer + bufferLength, 0, 56 - bufferLength);
+    for (int i = 0; i < 8; i++) {
+        buffer[63 - i] = (unsigned char)(bitLength >> (i * 8));
+    }
+    compress(buffer);
+
+    for (int i = 0; i < 8; i++) {
+        digest[i * 4] = (unsigned char)(state[i] >> 24);
+        digest[i * 4 + 1] = (unsigned char)(state[i] >> 16);
+        digest[i * 4 + 2] = (unsigned char)(state[i] >> 8);
+        digest[i * 4 + 3] = (unsigned char)state[i];
+    }
+    reset();
+}
+
+// Digest of one buffer
+void sha256(const void* data, size_t length, unsigned char digest[SHA256_BYTES]) {
+    Sha256 h;
+    h.update(data, length);
+    h.final(digest);
+}
@@ -0,0 +1,35 @@
+// Sha256.h - SHA-256 message digest (FIPS 180-4)
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <cstddef>
+
+// Bytes in a digest
+const int SHA256_BYTES = 32;
+
+// Incremental SHA-256: update() any number of times, then final()
+class Sha256 {
+private:
+    unsigned int state[8];
+    unsigned char buffer[64];
+    int bufferLength;
+    unsigned long long totalLength;   // bytes hashed so far
+
+    void compress(const unsigned char* block);
+
+public:
+    Sha256();
+
+    // Start a new digest
+    void reset();
+
+    void update(const void* data, size_t length);
+
+    // Write the digest and reset
+    void final(unsigned char digest[SHA256_BYTES]);
+};
+
+// Digest of one buffer
+void sha256(const void* data, size_t length, unsigned char digest[SHA256_BYTES]);
+
+#endif // SHA256_H
@@ -0,0 +1,286 @@
+// Snapshot.cpp - Roster snapshot file for fast program start
+//
+// File layout:
+//   header  : "SSNP", version (4 bytes), record count (8), page count (8)
+//   fences  : first packed ID of every page (8 bytes each)
+//   records : StudentRecord (see PagedRoster.h) sorted by ID, RECORDS_PER_PAGE
+//             records per page, the last page is not padded
+//
+// Opening reads only the header and the fences (about 1.2 MB for 10 million
+// students). A lookup by ID finds its page in the fences and reads that page.
+#include "Snapshot.h"
+#include "ChangeFeed.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
+
+static const char SNAPSHOT_MAGIC[4] = {'S', 'S', 'N', 'P'};
+static const unsigned int SNAPSHOT_VERSION = 1;
+static const int SNAPSHOT_HEADER_BYTES = 24;
+
+// Records read with one request by the background loader
+static const int LOAD_CHUNK_RECORDS = 4096;
+
+// Records encoded before one write
+static const int WRITE_CHUNK_RECORDS = 1024;
+
+// Offset of the first record
+static long long recordsOffset(long long pageCount) {
+    return SNAPSHOT_HEADER_BYTES + pageCount * 8;
+}
+
+// Sort students by ID and write the header, fences and records
+static bool encodeSnapshot(const Student* const* list, int count, ofstream* file,
+                           AsyncWriter* writer, int handle) {
+    unsigned long long* keys = new unsigned long long[count > 0 ? count : 1];
+    int* order = new int[count > 0 ? count : 1];
+    for (int i = 0; i < count; i++) {
+        keys[i] = packStudentId(list[i]->getStudentId());
+        order[i] = i;
+    }
+    sort(order, order + count, [keys](int a, int b) { return keys[a] < keys[b]; });
+
+    unsigned long long pages = (count + RECORDS_PER_PAGE - 1) / RECORDS_PER_PAGE;
+    unsigned long long total = count;
+    string data(SNAPSHOT_MAGIC, 4);
+    data.append((const char*)&SNAPSHOT_VERSION, 4);
+    data.append((const char*)&total, 8);
+    data.append((const char*)&pages, 8);
+    for (unsigned long long p = 0; p < pages; p++) {
+        data.append((const char*)&keys[order[p * RECORDS_PER_PAGE]], 8);
+    }
+
+    // Header and fences go out together with the first records
+    StudentRecord* chunk = new StudentRecord[WRITE_CHUNK_RECORDS];
+    bool ok = true;
+    int start = 0;
+    do {
+        int n = count - start;
+        if (n > WRITE_CHUNK_RECORDS) n = WRITE_CHUNK_RECORDS;
+        for (int i = 0; i < n; i++) {
+            toRecord(*list[order[start + i]], chunk[i]);
+        }
+        if (n > 0) {
+            data.append((const char*)chunk, n * sizeof(StudentRecord));
+        }
+        if (file != nullptr) {
+            file->write(data.data(), data.size());
+            ok = (bool)*file;
+        } else {
+            ok = writer->write(handle, data);
+        }
+        data.clear();
+        start += WRITE_CHUNK_RECORDS;
+    } while (start < count && ok);
+
+    delete[] chunk;
+    delete[] keys;
+    delete[] order;
+    return ok;
+}
+
+// Write students to a snapshot file
+bool writeSnapshot(const string& fileName, const Student* const* list, int count) {
+    ofstream file(fileName.c_str(), ios::binary | ios::trunc);
+    if (!file) {
+        return false;
+    }
+    return encodeSnapshot(list, count, &file, nullptr, -1);
+}
+
+// Encode a snapshot and queue it on an async writer
+bool writeSnapshot(AsyncWriter& writer, int handle, const Student* const* list, int count) {
+    return encodeSnapshot(list, count, nullptr, &writer, handle);
+}
+
+// Constructor
+Snapshot::Snapshot() : loaded(0), loadDone(false) {
+    recordCount = 0;
+    pageCount = 0;
+    fences = nullptr;
+    page = new StudentRecord[RECORDS_PER_PAGE];
+    lookups = 0;
+    loadOk = false;
+    loadMillis = 0;
+}
+
+// Destructor
+Snapshot::~Snapshot() {
+    waitLoaded();
+    close();
+    delete[] page;
+}
+
+// Read the header and fence index
+bool Snapshot::open(const string& name) {
+    close();
+    file.open(name.c_str(), ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    char header[SNAPSHOT_HEADER_BYTES];
+    file.read(header, SNAPSHOT_HEADER_BYTES);
+    unsigned int version = 0;
+    unsigned long long total = 0;
+    unsigned long long pages = 0;
+    memcpy(&version, header + 4, 4);
+    memcpy(&total, header + 8, 8);
+    memcpy(&pages, header + 16, 8);
+    if (!file || memcmp(header, SNAPSHOT_MAGIC, 4) != 0 || version != SNAPSHOT_VERSION
+        || total > (unsigned long long)INT_MAX
+        || pages != (total + RECORDS_PER_PAGE - 1) / RECORDS_PER_PAGE) {
+        file.close();
+        return false;
+    }
+
+    // The counts must describe exactly this file before anything is allocated
+    file.seekg(0, ios::end);
+    long long fileSize = (long long)file.tellg();
+    if (fileSize != recordsOffset((long long)pages) + (long long)total * (long long)sizeof(StudentRecord)) {
+        file.close();
+        return false;
+    }
+    file.seekg(SNAPSHOT_HEADER_BYTES);
+
+    recordCount = (long long)total;
+    pageCount = (long long)pages;
+    fences = new unsigned long long[pageCount > 0 ? pageCount : 1];
+    file.read((char*)fences, pageCount * 8);
+    if (!file) {
+        close();
+        return false;
+    }
+    fileName = name;
+    return true;
+}
+
+void Snapshot::close() {
+    if (file.is_open()) {
+        file.close();
+    }
+    delete[] fences;
+    fences = nullptr;
+    recordCount = 0;
+    pageCount = 0;
+}
+
+bool Snapshot::isOpen() const {
+    return fences != nullptr;
+}
+
+long long Snapshot::size() const {
+    return recordCount;
+}
+
+// Find a student by ID: one page read located through the fences
+bool Snapshot::find(const string& id, Student& out) {
+    if (!isOpen() || !isValidId(id)) {
+        return false;
+    }
+    unsigned long long key = packStudentId(id);
+    long long p = (long long)(upper_bound(fences, fences + pageCount, key) - fences) - 1;
+    if (p < 0) {
+        return false;
+    }
+    long long first = p * RECORDS_PER_PAGE;
+    int n = (int)min((long long)RECORDS_PER_PAGE, recordCount - first);
+    file.clear();
+    file.seekg(recordsOffset(pageCount) + first * (long long)sizeof(StudentRecord));
+    file.read((char*)page, n * sizeof(StudentRecord));
+    if (!file) {
+        return false;
+    }
+    lookups++;
+
+    // Records in a page are sorted, and equal-length digit strings compare
+    // the same way as numbers
+    int low = 0;
+    int high = n - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        int c = memcmp(page[mid].studentId, id.data(), 10);
+        if (c == 0) {
+            return fromRecord(page[mid], out);
+        }
+        if (c < 0) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return false;
+}
+
+long long Snapshot::getLookups() const {
+    return lookups;
+}
+
+// Background thread: read records in large chunks and add them to the roster
+void Snapshot::runLoad(Roster* roster) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    ifstream in(fileName.c_str(), ios::binary);
+    in.seekg(recordsOffset(pageCount));
+    loadOk = (bool)in;
+
+    roster->reserve((int)recordCount);
+    StudentRecord* chunk = new StudentRecord[LOAD_CHUNK_RECORDS];
+    Student s;
+    long long done = 0;
+    while (loadOk && done < recordCount) {
+        int n = (int)min((long long)LOAD_CHUNK_RECORDS, recordCount - done);
+        in.read((char*)chunk, n * sizeof(StudentRecord));
+        if (!in) {
+            loadOk = false;
+            break;
+        }
+        for (int i = 0; i < n && loadOk; i++) {
+            if (fromRecord(chunk[i], s)) {
+                roster->add(s);
+                done++;
+            } else {
+                // Damaged record: stop, the roster keeps what was read so far
+                loadOk = false;
+            }
+        }
+        loaded.store(done, memory_order_relaxed);
+    }
+    delete[] chunk;
+
+    loadMillis = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    loadDone.store(true, memory_order_release);
+}
+
+// Fill an empty roster on a background thread
+void Snapshot::startLoad(Roster& roster) {
+    waitLoaded();
+    loaded.store(0);
+    loadDone.store(false);
+    loadOk = false;
+    loader = thread(&Snapshot::runLoad, this, &roster);
+}
+
+bool Snapshot::isLoading() const {
+    return loader.joinable();
+}
+
+bool Snapshot::isLoaded() const {
+    return loadDone.load(memory_order_acquire);
+}
+
+// Wait for the background load
+bool Snapshot::waitLoaded() {
+    if (loader.joinable()) {
+        loader.join();
+    }
+    return loadOk;
+}
+
+long long Snapshot::getLoadedCount() const {
+    return loaded.load(memory_order_relaxed);
+}
+
+double Snapshot::getLoadMillis() const {
+    return loadMillis;
+}
@@ -0,0 +1,75 @@
+// Snapshot.h - Roster snapshot file for fast program start
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "Roster.h"
+#include "PagedRoster.h"
+#include "AsyncWriter.h"
+#include <fstream>
+#include <thread>
+#include <atomic>
+
+// Write students to a snapshot file (students are stored sorted by ID)
+bool writeSnapshot(const string& fileName, const Student* const* list, int count);
+
+// Encode a snapshot and queue it on a file opened with writer.openFile()
+bool writeSnapshot(AsyncWriter& writer, int handle, const Student* const* list, int count);
+
+// A snapshot opened for fast start. open() reads only the header and the
+// page fence index (first ID of every page), so lookups by ID work at once
+// with one page read each. startLoad() fills a roster on a background
+// thread; the roster must not be used until isLoaded() or waitLoaded().
+class Snapshot {
+private:
+    ifstream file;               // lookups on the calling thread
+    string fileName;
+    long long recordCount;
+    long long pageCount;
+    unsigned long long* fences;  // first packed ID of each page
+    StudentRecord* page;         // page buffer for lookups
+    long long lookups;
+
+    // Background load
+    thread loader;
+    atomic<long long> loaded;
+    atomic<bool> loadDone;
+    bool loadOk;
+    double loadMillis;
+
+    // Not copyable
+    Snapshot(const Snapshot& other);
+    Snapshot& operator=(const Snapshot& other);
+
+    void runLoad(Roster* roster);
+
+public:
+    Snapshot();
+    ~Snapshot();
+
+    // Read the header and fence index, false if not a snapshot file
+    bool open(const string& name);
+    void close();
+    bool isOpen() const;
+    long long size() const;
+
+    // Find a student by ID in the file
+    bool find(const string& id, Student& out);
+    long long getLookups() const;
+
+    // Fill an empty roster on a background thread
+    void startLoad(Roster& roster);
+
+    // A load was started and not yet waited for
+    bool isLoading() const;
+
+    // The background thread has finished with the roster
+    bool isLoaded() const;
+
+    // Wait for the background load, false if the file could not be read
+    bool waitLoaded();
+
+    long long getLoadedCount() const;
+    double getLoadMillis() const;
+};
+
+#endif // SNAPSHOT_H
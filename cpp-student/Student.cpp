@@ -1,17 +1,26 @@
 // Student.cpp - Student class member function implementation
 #include "Student.h"
+#include "StudentT.h"
+#include "ChangeFeed.h"
+#include "Validate.h"
+#include "AuditLog.h"
+#include <atomic>
+
+// Setter changes of IDs, scores and course counts
+static atomic<unsigned long long> editCount(0);
+
+unsigned long long studentEditCount() {
+    return editCount.load(memory_order_relaxed);
+}
 
 // Validation helper functions
 bool isValidId(const string& id) {
     if (id.length() != 10) {
         return false;
     }
-    for (int i = 0; i < 10; i++) {
-        if (id[i] < '0' || id[i] > '9') {
-            return false;
-        }
-    }
-    return true;
+    // Check 8 digits at once, then the last two
+    unsigned long long packed;
+    return parseId10(id.data(), packed);
 }
 
 bool isValidName(const string& n) {
@@ -29,6 +38,35 @@ bool isValidScore(double score) {
     return (score >= 0 && score <= 100);
 }
 
+// Convert a valid 10-digit ID to an integer (leading zeros are kept by unpack)
+unsigned long long packStudentId(const string& id) {
+    unsigned long long value = 0;
+    if (id.length() == 10 && parseId10(id.data(), value)) {
+        return value;
+    }
+    value = 0;
+    for (int i = 0; i < (int)id.length(); i++) {
+        value = value * 10 + (id[i] - '0');
+    }
+    return value;
+}
+
+// Estimated bytes a heap allocation of the requested size takes
+long long heapBlockBytes(long long requested) {
+    long long bytes = (requested + 8 + 15) / 16 * 16;
+    return bytes < 32 ? 32 : bytes;
+}
+
+// Convert a packed ID back to its 10-digit string form
+string unpackStudentId(unsigned long long packed) {
+    string id = "0000000000";
+    for (int i = 9; i >= 0; i--) {
+        id[i] = (char)('0' + packed % 10);
+        packed /= 10;
+    }
+    return id;
+}
+
 // Default constructor
 Student::Student() {
     studentId = "0000000000";
@@ -41,7 +79,7 @@ Student::Student() {
 }
 
 // Parameterized constructor
-Student::Student(string id, string n, int a, char g, int cc) {
+Student::Student(const string& id, const string& n, int a, char g, int cc) {
     studentId = id;
     name = n;
     age = a;
@@ -110,21 +148,30 @@ Student::~Student() {
 }
 
 // Setter functions
-bool Student::setStudentId(string id) {
+bool Student::setStudentId(const string& id) {
     if (!isValidId(id)) {
         cout << "Error: Student ID must be exactly 10 digits!" << endl;
         return false;
     }
+    string oldId = studentId;
     studentId = id;
+    if (oldId != id) {
+        editCount.fetch_add(1, memory_order_relaxed);
+        publishIdChange(oldId, id);
+    }
     return true;
 }
 
-bool Student::setName(string n) {
+bool Student::setName(const string& n) {
     if (!isValidName(n)) {
         cout << "Error: Name cannot be empty and must not exceed 8 characters!" << endl;
         return false;
     }
+    string oldName = name;
     name = n;
+    if (oldName != n) {
+        publishNameChange(studentId, oldName, n);
+    }
     return true;
 }
 
@@ -155,7 +202,13 @@ bool Student::setScore(int index, double score) {
         cout << "Error: Score must be between 0 and 100!" << endl;
         return false;
     }
+    double oldScore = scores[index];
     scores[index] = score;
+    if (oldScore != score) {
+        editCount.fetch_add(1, memory_order_relaxed);
+        publishScoreChange(studentId, index, oldScore, score);
+        recordScoreChange(studentId, index, oldScore, score);
+    }
     return true;
 }
 
@@ -167,6 +220,7 @@ bool Student::setCourseCount(int cc) {
     
     // Delete old scores array
     delete[] scores;
+    editCount.fetch_add(1, memory_order_relaxed);
     
     courseCount = cc;
     scores = new double[courseCount];
@@ -216,6 +270,16 @@ double Student::calcAverage() {
         return 0.0;
     }
     
+    // Use the unrolled kernel for the two student types
+    switch (courseCount) {
+        case 3:
+            avgScore = calcAverageT<3>(scores);
+            return avgScore;
+        case 5:
+            avgScore = calcAverageT<5>(scores);
+            return avgScore;
+    }
+    
     double sum = 0.0;
     for (int i = 0; i < courseCount; i++) {
         sum += scores[i];
@@ -238,8 +302,37 @@ double Student::calcAverage(int start, int end) {
     return sum / count;
 }
 
+// Heap bytes of a string, 0 when it fits in the string's own buffer
+static long long stringHeap(const string& text) {
+    const char* data = text.data();
+    const char* object = (const char*)&text;
+    if (data >= object && data < object + sizeof(text)) {
+        return 0;
+    }
+    return heapBlockBytes((long long)text.capacity() + 1);
+}
+
+// ID and name characters stored outside the object
+long long Student::stringHeapBytes() const {
+    return stringHeap(studentId) + stringHeap(name);
+}
+
+// Score array on the heap
+long long Student::scoreHeapBytes() const {
+    if (scores == nullptr) {
+        return 0;
+    }
+    return heapBlockBytes((long long)courseCount * sizeof(double));
+}
+
 // Check if student has failed courses
 bool Student::hasFailedCourse() const {
+    switch (courseCount) {
+        case 3:
+            return hasFailedCourseT<3>(scores);
+        case 5:
+            return hasFailedCourseT<5>(scores);
+    }
     for (int i = 0; i < courseCount; i++) {
         if (scores[i] < 60) {
             return true;
@@ -249,27 +342,27 @@ bool Student::hasFailedCourse() const {
 }
 
 // Display full information
-void Student::display() const {
-    cout << "========================================" << endl;
-    cout << "Student ID    : " << studentId << endl;
-    cout << "Name          : " << name << endl;
-    cout << "Age           : " << age << endl;
-    cout << "Gender        : " << (gender == 'M' ? "Male" : "Female") << endl;
-    cout << "Course Count  : " << courseCount << endl;
-    cout << "Scores        : ";
+void Student::display(ostream& out) const {
+    out << "========================================" << endl;
+    out << "Student ID    : " << studentId << endl;
+    out << "Name          : " << name << endl;
+    out << "Age           : " << age << endl;
+    out << "Gender        : " << (gender == 'M' ? "Male" : "Female") << endl;
+    out << "Course Count  : " << courseCount << endl;
+    out << "Scores        : ";
     for (int i = 0; i < courseCount; i++) {
-        cout << "Course" << (i + 1) << ":" << scores[i];
-        if (i < courseCount - 1) cout << ", ";
+        out << "Course" << (i + 1) << ":" << scores[i];
+        if (i < courseCount - 1) out << ", ";
     }
-    cout << endl;
-    cout << "Average Score : " << avgScore << endl;
-    cout << "Failed Course : " << (hasFailedCourse() ? "Yes" : "No") << endl;
-    cout << "========================================" << endl;
+    out << endl;
+    out << "Average Score : " << avgScore << endl;
+    out << "Failed Course : " << (hasFailedCourse() ? "Yes" : "No") << endl;
+    out << "========================================" << endl;
 }
 
 // Display brief information
-void Student::displayBrief() const {
-    cout << studentId << "\t" << name << "\t" << gender << "\t" << avgScore << endl;
+void Student::displayBrief(ostream& out) const {
+    out << studentId << "\t" << name << "\t" << gender << "\t" << avgScore << endl;
 }
 
 // Helper function to clear cin error state
@@ -375,7 +468,7 @@ void Student::inputInfo() {
 }
 
 // Modify student information
-void Student::modifyInfo() {
+void Student::modifyInfo(bool (*idTaken)(const string& id)) {
     int choice;
     cout << "\n--- Modify Student Information ---" << endl;
     cout << "1. Modify Student ID" << endl;
@@ -400,7 +493,9 @@ void Student::modifyInfo() {
             cin >> newId;
             // Clear remaining input in buffer
             clearCinError();
-            if (setStudentId(newId)) {
+            if (newId != studentId && idTaken != nullptr && idTaken(newId)) {
+                cout << "Error: This student ID already exists!" << endl;
+            } else if (setStudentId(newId)) {
                 cout << "Student ID modified successfully!" << endl;
             }
             break;
@@ -17,12 +17,15 @@ private:
     double* scores;      // dynamic array for course scores
     double avgScore;     // average score
 
+    // Bulk average recompute writes avgScore directly
+    friend class ScoreColumns;
+
 public:
     // Default constructor
     Student();
     
     // Parameterized constructor
-    Student(string id, string n, int a, char g, int cc);
+    Student(const string& id, const string& n, int a, char g, int cc);
     
     // Copy constructor
     Student(const Student& other);
@@ -34,8 +37,8 @@ public:
     ~Student();
     
     // Setter functions with validation
-    bool setStudentId(string id);
-    bool setName(string n);
+    bool setStudentId(const string& id);
+    bool setName(const string& n);
     bool setAge(int a);
     bool setGender(char g);
     bool setScore(int index, double score);
@@ -54,18 +57,23 @@ public:
     double calcAverage();                      // all courses
     double calcAverage(int start, int end);   // range of courses
     
+    // Heap bytes owned by this student (allocator rounding included)
+    long long stringHeapBytes() const;   // ID and name stored outside the object
+    long long scoreHeapBytes() const;    // score array
+    
     // Check if student has failed courses
     bool hasFailedCourse() const;
     
     // Display functions
-    void display() const;       // full information
-    void displayBrief() const;  // brief information
+    void display(ostream& out = cout) const;       // full information
+    void displayBrief(ostream& out = cout) const;  // brief information
     
     // Input student information
     void inputInfo();
     
-    // Modify student information
-    void modifyInfo();
+    // Modify student information. A new ID for which idTaken returns true is
+    // rejected before anything changes.
+    void modifyInfo(bool (*idTaken)(const string& id) = nullptr);
 };
 
 // Validation helper functions
@@ -74,4 +82,16 @@ bool isValidName(const string& n);
 bool isValidGender(char g);
 bool isValidScore(double score);
 
+// Estimated bytes a heap allocation of the requested size takes (an 8-byte
+// header, rounded up to 16 bytes, at least 32 bytes, as in glibc malloc)
+long long heapBlockBytes(long long requested);
+
+// Number of ID, score and course count changes made through the Student
+// setters so far (any student, any thread). Used to detect stale copies.
+unsigned long long studentEditCount();
+
+// Packed ID helpers (10-digit ID <-> 64-bit integer)
+unsigned long long packStudentId(const string& id);
+string unpackStudentId(unsigned long long packed);
+
 #endif // STUDENT_H
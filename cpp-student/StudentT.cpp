@@ -0,0 +1,176 @@
+// StudentT.cpp - Score columns for 3-course and 5-course students
+#include "StudentT.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// out[i] = (columns[0][i] + ... + columns[n - 1][i]) / n for count students.
+// Lanes hold consecutive students and the courses are added in the same
+// order as calcAverageT, so the results are identical to the scalar loop.
+static void averageColumns(const double* const* columns, int n, int count, double* out) {
+    int i = 0;
+#if defined(__AVX__)
+    const __m256d divisor4 = _mm256_set1_pd((double)n);
+    for (; i + 4 <= count; i += 4) {
+        __m256d sum = _mm256_setzero_pd();
+        for (int c = 0; c < n; c++) {
+            sum = _mm256_add_pd(sum, _mm256_loadu_pd(columns[c] + i));
+        }
+        _mm256_storeu_pd(out + i, _mm256_div_pd(sum, divisor4));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128d divisor2 = _mm_set1_pd((double)n);
+    for (; i + 2 <= count; i += 2) {
+        __m128d sum = _mm_setzero_pd();
+        for (int c = 0; c < n; c++) {
+            sum = _mm_add_pd(sum, _mm_loadu_pd(columns[c] + i));
+        }
+        _mm_storeu_pd(out + i, _mm_div_pd(sum, divisor2));
+    }
+#endif
+    // Remaining students (all of them without SSE2)
+    for (; i < count; i++) {
+        double sum = 0.0;
+        for (int c = 0; c < n; c++) {
+            sum += columns[c][i];
+        }
+        out[i] = sum / n;
+    }
+}
+
+// Constructor
+ScoreColumns::ScoreColumns() {
+    count3 = 0;
+    count5 = 0;
+    index3 = nullptr;
+    index5 = nullptr;
+    data3 = nullptr;
+    data5 = nullptr;
+    avg3 = nullptr;
+    avg5 = nullptr;
+}
+
+// Destructor
+ScoreColumns::~ScoreColumns() {
+    release();
+}
+
+// Free all columns
+void ScoreColumns::release() {
+    delete[] index3;
+    delete[] index5;
+    delete[] data3;
+    delete[] data5;
+    delete[] avg3;
+    delete[] avg5;
+    index3 = nullptr;
+    index5 = nullptr;
+    data3 = nullptr;
+    data5 = nullptr;
+    avg3 = nullptr;
+    avg5 = nullptr;
+    count3 = 0;
+    count5 = 0;
+}
+
+// Copy the scores of every student into the columns of its course count
+void ScoreColumns::build(const Student* const* list, int count) {
+    release();
+
+    int n3 = 0;
+    int n5 = 0;
+    for (int i = 0; i < count; i++) {
+        if (list[i]->getCourseCount() == 3) n3++;
+        if (list[i]->getCourseCount() == 5) n5++;
+    }
+    index3 = new int[n3 > 0 ? n3 : 1];
+    index5 = new int[n5 > 0 ? n5 : 1];
+    data3 = new double[n3 > 0 ? n3 * 3 : 1];
+    data5 = new double[n5 > 0 ? n5 * 5 : 1];
+    avg3 = new double[n3 > 0 ? n3 : 1];
+    avg5 = new double[n5 > 0 ? n5 : 1];
+    for (int i = 0; i < count; i++) {
+        const Student& s = *list[i];
+        if (s.courseCount == 3) {
+            for (int c = 0; c < 3; c++) {
+                data3[c * n3 + count3] = s.scores[c];
+            }
+            avg3[count3] = s.avgScore;
+            index3[count3++] = i;
+        } else if (s.courseCount == 5) {
+            for (int c = 0; c < 5; c++) {
+                data5[c * n5 + count5] = s.scores[c];
+            }
+            avg5[count5] = s.avgScore;
+            index5[count5++] = i;
+        }
+    }
+}
+
+int ScoreColumns::getCount3() const {
+    return count3;
+}
+
+int ScoreColumns::getCount5() const {
+    return count5;
+}
+
+// Recompute every average
+void ScoreColumns::recomputeAverages() {
+    const double* columns[5];
+    for (int c = 0; c < 3; c++) {
+        columns[c] = data3 + (long long)c * count3;
+    }
+    averageColumns(columns, 3, count3, avg3);
+    for (int c = 0; c < 5; c++) {
+        columns[c] = data5 + (long long)c * count5;
+    }
+    averageColumns(columns, 5, count5, avg5);
+}
+
+// out[position] = average of courses start..end, -1 without those courses
+void ScoreColumns::rangeAverages(int start, int end, double* out) const {
+    const double* columns[5];
+    int n = end - start + 1;
+
+    // Averages are computed into a contiguous buffer, then scattered
+    int largest = count3 > count5 ? count3 : count5;
+    double* buffer = new double[largest > 0 ? largest : 1];
+
+    bool valid3 = start >= 0 && start <= end && end < 3;
+    if (valid3) {
+        for (int c = 0; c < n; c++) {
+            columns[c] = data3 + (long long)(start + c) * count3;
+        }
+        averageColumns(columns, n, count3, buffer);
+    }
+    for (int i = 0; i < count3; i++) {
+        out[index3[i]] = valid3 ? buffer[i] : -1;
+    }
+
+    bool valid5 = start >= 0 && start <= end && end < 5;
+    if (valid5) {
+        for (int c = 0; c < n; c++) {
+            columns[c] = data5 + (long long)(start + c) * count5;
+        }
+        averageColumns(columns, n, count5, buffer);
+    }
+    for (int i = 0; i < count5; i++) {
+        out[index5[i]] = valid5 ? buffer[i] : -1;
+    }
+    delete[] buffer;
+}
+
+// Store the recomputed averages in the students
+void ScoreColumns::writeAverages(Student* const* list) const {
+    for (int i = 0; i < count3; i++) {
+        list[index3[i]]->avgScore = avg3[i];
+    }
+    for (int i = 0; i < count5; i++) {
+        list[index5[i]]->avgScore = avg5[i];
+    }
+}
@@ -0,0 +1,74 @@
+// StudentT.h - Fixed course count kernels and column score storage
+#ifndef STUDENTT_H
+#define STUDENTT_H
+
+#include "Student.h"
+
+// Sum of N scores, the loop has a constant trip count and is fully unrolled
+template <int N>
+inline double sumScoresT(const double* scores) {
+    double sum = 0.0;
+    for (int i = 0; i < N; i++) {
+        sum += scores[i];
+    }
+    return sum;
+}
+
+// Average of N scores
+template <int N>
+inline double calcAverageT(const double* scores) {
+    return sumScoresT<N>(scores) / N;
+}
+
+// Check N scores for a failed course without early exit (no branches)
+template <int N>
+inline bool hasFailedCourseT(const double* scores) {
+    bool failed = false;
+    for (int i = 0; i < N; i++) {
+        failed = failed | (scores[i] < 60);
+    }
+    return failed;
+}
+
+// Roster scores stored column by column: one array per course for each
+// course count, so a SIMD register holds the same course of consecutive
+// students and averages need no horizontal adds
+class ScoreColumns {
+private:
+    int count3;
+    int count5;
+    int* index3;                 // roster position of each 3-course student
+    int* index5;
+    double* data3;               // column c of the 3-course group starts at c * count3
+    double* data5;
+    double* avg3;
+    double* avg5;
+
+    // Not copyable
+    ScoreColumns(const ScoreColumns& other);
+    ScoreColumns& operator=(const ScoreColumns& other);
+
+    void release();
+
+public:
+    ScoreColumns();
+    ~ScoreColumns();
+
+    // Copy the scores of every student into the columns of its course count
+    void build(const Student* const* list, int count);
+
+    int getCount3() const;
+    int getCount5() const;
+
+    // Recompute every average, same results as Student::calcAverage()
+    void recomputeAverages();
+
+    // out[position] = average of courses start..end (0-based) as
+    // Student::calcAverage(start, end), -1 for students without those courses
+    void rangeAverages(int start, int end, double* out) const;
+
+    // Store the recomputed averages in the students
+    void writeAverages(Student* const* list) const;
+};
+
+#endif // STUDENTT_H
@@ -0,0 +1,116 @@
+// Validate.cpp - Batch validation for bulk ingest of IDs, names and scores
+//
+// IDs are checked and converted 8 characters at a time inside one 64-bit
+// integer (SWAR). Scores are range checked without branches; on SSE2 targets
+// two scores are compared per instruction.
+#include "Validate.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VALIDATE_USE_SSE2 1
+#endif
+
+static const unsigned long long HIGH_NIBBLES = 0xF0F0F0F0F0F0F0F0ULL;
+static const unsigned long long ALL_THREES = 0x3030303030303030ULL;
+static const unsigned long long ALL_SIXES = 0x0606060606060606ULL;
+
+// Load 8 characters with the first character in the lowest byte
+static unsigned long long load8(const char* p) {
+    unsigned long long x;
+    memcpy(&x, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    x = __builtin_bswap64(x);
+#endif
+    return x;
+}
+
+int errorBitmapWords(int rows) {
+    return (rows + 63) / 64;
+}
+
+void clearErrorBitmap(unsigned long long* errors, int rows) {
+    int words = errorBitmapWords(rows);
+    for (int w = 0; w < words; w++) {
+        errors[w] = 0;
+    }
+}
+
+bool rowHasError(const unsigned long long* errors, int row) {
+    return (errors[row / 64] >> (row % 64)) & 1;
+}
+
+// Every byte must be 0x30-0x39: high nibble is 3, and adding 6 keeps it 3
+bool isDigits8(const char* p) {
+    unsigned long long x = load8(p);
+    return ((x & HIGH_NIBBLES) == ALL_THREES)
+        && (((x + ALL_SIXES) & HIGH_NIBBLES) == ALL_THREES);
+}
+
+// Combine digit pairs, then pairs of pairs, then the two halves
+unsigned long long parseDigits8(const char* p) {
+    unsigned long long x = load8(p) - ALL_THREES;
+    x = (x * 10 + (x >> 8)) & 0x00FF00FF00FF00FFULL;
+    x = (x * 100 + (x >> 16)) & 0x0000FFFF0000FFFFULL;
+    x = (x * 10000 + (x >> 32)) & 0x00000000FFFFFFFFULL;
+    return x;
+}
+
+bool parseId10(const char* p, unsigned long long& packed) {
+    unsigned int d8 = (unsigned char)p[8] - '0';
+    unsigned int d9 = (unsigned char)p[9] - '0';
+    if (!isDigits8(p) || d8 > 9 || d9 > 9) {
+        return false;
+    }
+    packed = parseDigits8(p) * 100 + d8 * 10 + d9;
+    return true;
+}
+
+int validateIdColumn(const string* ids, int rows, unsigned long long* packed, unsigned long long* errors) {
+    int invalid = 0;
+    for (int i = 0; i < rows; i++) {
+        unsigned long long value = 0;
+        bool ok = ids[i].length() == 10 && parseId10(ids[i].data(), value);
+        packed[i] = ok ? value : 0;
+        if (!ok) {
+            errors[i / 64] |= 1ULL << (i % 64);
+            invalid++;
+        }
+    }
+    return invalid;
+}
+
+int validateNameColumn(const string* names, int rows, unsigned long long* errors) {
+    int invalid = 0;
+    for (int i = 0; i < rows; i++) {
+        size_t len = names[i].length();
+        unsigned long long bad = (len == 0 || len > 8) ? 1 : 0;
+        errors[i / 64] |= bad << (i % 64);
+        invalid += (int)bad;
+    }
+    return invalid;
+}
+
+int validateScoreColumn(const double* scores, int rows, unsigned long long* errors) {
+    int invalid = 0;
+    int i = 0;
+#ifdef VALIDATE_USE_SSE2
+    const __m128d low = _mm_set1_pd(0.0);
+    const __m128d high = _mm_set1_pd(100.0);
+    for (; i + 1 < rows; i += 2) {
+        __m128d v = _mm_loadu_pd(scores + i);
+        // Both comparisons are false for NaN, so NaN counts as invalid
+        __m128d ok = _mm_and_pd(_mm_cmpge_pd(v, low), _mm_cmple_pd(v, high));
+        unsigned long long bad = (unsigned long long)(~_mm_movemask_pd(ok) & 3);
+        // i is even, so both rows fall into the same bitmap word
+        errors[i / 64] |= bad << (i % 64);
+        invalid += (int)((bad & 1) + (bad >> 1));
+    }
+#endif
+    for (; i < rows; i++) {
+        unsigned long long bad = (scores[i] >= 0 && scores[i] <= 100) ? 0 : 1;
+        errors[i / 64] |= bad << (i % 64);
+        invalid += (int)bad;
+    }
+    return invalid;
+}
@@ -0,0 +1,33 @@
+// Validate.h - Batch validation for bulk ingest of IDs, names and scores
+#ifndef VALIDATE_H
+#define VALIDATE_H
+
+#include "Student.h"
+
+// Error bitmaps hold one bit per row: bit (row % 64) of word (row / 64).
+// The column functions OR their bits in, so several columns can share one
+// bitmap. Clear it first with clearErrorBitmap().
+int errorBitmapWords(int rows);
+void clearErrorBitmap(unsigned long long* errors, int rows);
+bool rowHasError(const unsigned long long* errors, int row);
+
+// Check 8 characters for '0'-'9' at once (SWAR)
+bool isDigits8(const char* p);
+
+// Convert 8 digit characters to a number at once (SWAR)
+unsigned long long parseDigits8(const char* p);
+
+// Check and convert a 10-digit ID, returns false if not all digits
+bool parseId10(const char* p, unsigned long long& packed);
+
+// Validate IDs and convert valid ones to packed integers (0 for invalid rows).
+// Returns the number of invalid rows.
+int validateIdColumn(const string* ids, int rows, unsigned long long* packed, unsigned long long* errors);
+
+// Validate name lengths (1-8 characters)
+int validateNameColumn(const string* names, int rows, unsigned long long* errors);
+
+// Validate scores (0-100, NaN is invalid)
+int validateScoreColumn(const double* scores, int rows, unsigned long long* errors);
+
+#endif // VALIDATE_H
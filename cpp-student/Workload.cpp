@@ -0,0 +1,520 @@
+// Workload.cpp - Seeded workload generator and replay harness
+#include "Workload.h"
+#include "Roster.h"
+#include "StudentT.h"
+#include "ChangeFeed.h"
+#include "AuditLog.h"
+#include "Validate.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <cstring>
+
+// First ID of a generated roster
+static const unsigned long long FIRST_GENERATED_ID = 2024000000ULL;
+
+// Multiplier that spreads Zipf ranks over the roster, so the hot students
+// are not neighbours (it is prime and larger than any roster, so rank -> index
+// is a permutation)
+static const unsigned long long RANK_SCATTER = 2654435761ULL;
+
+// Syllables for generated names (two syllables, at most 8 characters)
+static const char* NAME_SYLLABLES[] = {
+    "an", "bo", "chen", "da", "fei", "gu", "hao", "jia", "kai", "li",
+    "ming", "na", "qi", "rui", "shu", "tao", "wen", "xin", "yu", "zhi"
+};
+static const int NAME_SYLLABLE_COUNT = 20;
+
+// One operation of a loaded trace
+struct WorkItem {
+    unsigned long long id;
+    double score;
+    unsigned char type;
+    unsigned char course;        // course index, or sort key (0 = ID, 1 = average)
+};
+
+// Constructor
+SplitMix64::SplitMix64(unsigned long long seed) {
+    state = seed;
+}
+
+unsigned long long SplitMix64::next() {
+    unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform in [0, bound), rejecting the short last interval
+unsigned long long SplitMix64::nextBelow(unsigned long long bound) {
+    unsigned long long limit = ~0ULL - (~0ULL % bound);
+    unsigned long long value = next();
+    while (value >= limit) {
+        value = next();
+    }
+    return value % bound;
+}
+
+double SplitMix64::nextDouble() {
+    return (double)(next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Constructor: sums the zeta series once (n terms)
+ZipfSampler::ZipfSampler(int count, double skew) {
+    n = count;
+    theta = skew;
+    zetaN = 0.0;
+    for (int i = 1; i <= n; i++) {
+        zetaN += 1.0 / pow((double)i, theta);
+    }
+    double zeta2 = 1.0 + 1.0 / pow(2.0, theta);
+    alpha = 1.0 / (1.0 - theta);
+    eta = (1.0 - pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetaN);
+    halfPowTheta = 1.0 + pow(0.5, theta);
+}
+
+int ZipfSampler::sample(SplitMix64& rng) const {
+    double u = rng.nextDouble();
+    double uz = u * zetaN;
+    if (uz < 1.0 || n < 2) {
+        return 0;
+    }
+    if (uz < halfPowTheta) {
+        return 1;
+    }
+    int rank = (int)(n * pow(eta * u - eta + 1.0, alpha));
+    return rank < n ? rank : n - 1;
+}
+
+// Default configuration
+void defaultWorkloadConfig(WorkloadConfig& config) {
+    config.seed = 1;
+    config.students = 100000;
+    config.operations = 100000;
+    config.fiveCoursePercent = 60;
+    config.mix[WORK_QUERY] = 800;
+    config.mix[WORK_MODIFY] = 197;
+    config.mix[WORK_STATS] = 2;
+    config.mix[WORK_SORT] = 1;
+    config.zipfTheta = 0.99;
+}
+
+// Score in hundredths between 40 and 100, most near 70
+static int randomScore(SplitMix64& rng) {
+    return 4000 + (int)rng.nextBelow(3001) + (int)rng.nextBelow(3000);
+}
+
+// Write a score given in hundredths, e.g. 8525 -> "85.25"
+static void writeScore(ofstream& out, int hundredths) {
+    out << (hundredths / 100) << "." << (char)('0' + hundredths / 10 % 10)
+        << (char)('0' + hundredths % 10);
+}
+
+// Write a roster and an operation trace to a text file
+bool generateWorkload(const WorkloadConfig& config, const string& fileName) {
+    if (config.students <= 0) {
+        return false;
+    }
+    ofstream out(fileName.c_str());
+    if (!out) {
+        return false;
+    }
+    SplitMix64 rng(config.seed);
+    int n = config.students;
+
+    out << "# Student workload trace\n";
+    out << "W " << config.seed << " " << n << " " << config.operations << " "
+        << config.fiveCoursePercent;
+    for (int t = 0; t < WORK_OP_TYPES; t++) {
+        out << " " << config.mix[t];
+    }
+    out << " " << config.zipfTheta << "\n";
+
+    // Roster: IDs in one dense block with a few gaps
+    unsigned long long* ids = new unsigned long long[n];
+    unsigned char* courseCounts = new unsigned char[n];
+    unsigned long long id = FIRST_GENERATED_ID;
+    for (int i = 0; i < n; i++) {
+        id += 1 + (rng.nextBelow(16) == 0 ? rng.nextBelow(50) : 0);
+        ids[i] = id;
+        courseCounts[i] = (unsigned char)(rng.nextBelow(100) < (unsigned long long)config.fiveCoursePercent ? 5 : 3);
+
+        string name = string(NAME_SYLLABLES[rng.nextBelow(NAME_SYLLABLE_COUNT)])
+                    + NAME_SYLLABLES[rng.nextBelow(NAME_SYLLABLE_COUNT)];
+        name[0] = (char)(name[0] - 'a' + 'A');
+        int age = 17 + (int)rng.nextBelow(8);
+        char gender = rng.nextBelow(2) == 0 ? 'M' : 'F';
+
+        out << "S " << id << " " << name << " " << age << " " << gender << " "
+            << (int)courseCounts[i];
+        for (int c = 0; c < courseCounts[i]; c++) {
+            out << " ";
+            writeScore(out, randomScore(rng));
+        }
+        out << "\n";
+    }
+
+    // Operations: students picked by Zipfian rank
+    ZipfSampler zipf(n, config.zipfTheta);
+    int mixTotal = 0;
+    for (int t = 0; t < WORK_OP_TYPES; t++) {
+        mixTotal += config.mix[t];
+    }
+    for (long long k = 0; k < config.operations && mixTotal > 0; k++) {
+        int pick = (int)rng.nextBelow(mixTotal);
+        int type = 0;
+        while (pick >= config.mix[type]) {
+            pick -= config.mix[type];
+            type++;
+        }
+        int index = (int)((unsigned long long)zipf.sample(rng) * RANK_SCATTER % n);
+        switch (type) {
+            case WORK_QUERY:
+                out << "Q " << ids[index] << "\n";
+                break;
+            case WORK_MODIFY:
+                out << "M " << ids[index] << " " << rng.nextBelow(courseCounts[index]) << " ";
+                writeScore(out, randomScore(rng));
+                out << "\n";
+                break;
+            case WORK_STATS:
+                out << "C\n";
+                break;
+            case WORK_SORT:
+                out << "R " << rng.nextBelow(2) << "\n";
+                break;
+        }
+    }
+
+    delete[] ids;
+    delete[] courseCounts;
+    out.close();
+    return !out.fail();
+}
+
+// Fold a 64-bit value into the result checksum (FNV-1a over 8 bytes)
+static void mixChecksum(unsigned long long& checksum, unsigned long long value) {
+    for (int i = 0; i < 8; i++) {
+        checksum = (checksum ^ ((value >> (i * 8)) & 0xFF)) * 1099511628211ULL;
+    }
+}
+
+static unsigned long long doubleBits(double value) {
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Append an operation, growing the array when full
+static void appendItem(WorkItem*& items, long long& count, long long& capacity, const WorkItem& item) {
+    if (count == capacity) {
+        long long newCapacity = capacity > 0 ? capacity * 2 : 1024;
+        WorkItem* newItems = new WorkItem[newCapacity];
+        for (long long i = 0; i < count; i++) {
+            newItems[i] = items[i];
+        }
+        delete[] items;
+        items = newItems;
+        capacity = newCapacity;
+    }
+    items[count++] = item;
+}
+
+// Roster rows of a trace are validated in column batches of this size
+static const int TRACE_BATCH_ROWS = 4096;
+
+// Parsed roster rows waiting for validation, one array per field
+struct TraceRosterBatch {
+    string ids[TRACE_BATCH_ROWS];
+    string names[TRACE_BATCH_ROWS];
+    int ages[TRACE_BATCH_ROWS];
+    char genders[TRACE_BATCH_ROWS];
+    int courseCounts[TRACE_BATCH_ROWS];
+    double scores[TRACE_BATCH_ROWS * 5];     // 5 per row, unused courses are 0
+    unsigned long long packed[TRACE_BATCH_ROWS];
+    unsigned long long errors[TRACE_BATCH_ROWS / 64];
+    unsigned long long scoreErrors[TRACE_BATCH_ROWS * 5 / 64];
+    int rows;
+};
+
+// Validate a batch column by column, then add its valid rows to the roster
+static void flushRosterBatch(TraceRosterBatch& batch, Roster& roster, long long& badLines) {
+    int rows = batch.rows;
+    clearErrorBitmap(batch.errors, rows);
+    clearErrorBitmap(batch.scoreErrors, rows * 5);
+    validateIdColumn(batch.ids, rows, batch.packed, batch.errors);
+    validateNameColumn(batch.names, rows, batch.errors);
+    validateScoreColumn(batch.scores, rows * 5, batch.scoreErrors);
+
+    for (int r = 0; r < rows; r++) {
+        bool ok = !rowHasError(batch.errors, r) && roster.findByPackedId(batch.packed[r]) < 0;
+        for (int c = 0; c < batch.courseCounts[r] && ok; c++) {
+            ok = !rowHasError(batch.scoreErrors, r * 5 + c);
+        }
+        if (!ok) {
+            badLines++;
+            continue;
+        }
+        Student s(batch.ids[r], batch.names[r], batch.ages[r], batch.genders[r], batch.courseCounts[r]);
+        for (int c = 0; c < batch.courseCounts[r]; c++) {
+            s.setScore(c, batch.scores[r * 5 + c]);
+        }
+        s.calcAverage();
+        roster.add(s);
+    }
+    batch.rows = 0;
+}
+
+// Read the roster into the roster object and the operations into items
+static bool loadTrace(const string& fileName, Roster& roster, WorkItem*& items,
+                      long long& count, long long& badLines) {
+    ifstream in(fileName.c_str());
+    if (!in) {
+        return false;
+    }
+    long long capacity = 0;
+    string line;
+    string rest;
+    TraceRosterBatch* batch = new TraceRosterBatch;
+    batch->rows = 0;
+    while (getline(in, line)) {
+        istringstream fields(line);
+        string tag;
+        if (!(fields >> tag) || tag[0] == '#') {
+            continue;
+        }
+        WorkItem item;
+        item.id = 0;
+        item.score = 0.0;
+        item.course = 0;
+        bool ok = true;
+        if (tag == "S") {
+            // Parse into the batch; IDs, names and scores are checked
+            // when the batch is validated
+            int r = batch->rows;
+            int courseCount;
+            fields >> batch->ids[r] >> batch->names[r] >> batch->ages[r]
+                   >> batch->genders[r] >> courseCount;
+            ok = !fields.fail() && (courseCount == 3 || courseCount == 5);
+            for (int c = 0; c < 5; c++) {
+                batch->scores[r * 5 + c] = 0.0;
+                if (ok && c < courseCount) {
+                    fields >> batch->scores[r * 5 + c];
+                    ok = !fields.fail();
+                }
+            }
+            if (ok) {
+                batch->courseCounts[r] = courseCount;
+                batch->rows++;
+                if (batch->rows == TRACE_BATCH_ROWS) {
+                    flushRosterBatch(*batch, roster, badLines);
+                }
+            }
+        } else if (tag == "W") {
+            int students = 0;
+            fields >> rest >> students;
+            if (!fields.fail() && students > 0) {
+                roster.reserve(students);
+            }
+        } else if (tag == "Q" || tag == "M") {
+            item.type = (unsigned char)(tag == "Q" ? WORK_QUERY : WORK_MODIFY);
+            fields >> item.id;
+            if (item.type == WORK_MODIFY) {
+                int course;
+                fields >> course >> item.score;
+                item.course = (unsigned char)course;
+                ok = !fields.fail() && course >= 0 && course < 5;
+            }
+            ok = ok && !fields.fail();
+            if (ok) {
+                appendItem(items, count, capacity, item);
+            }
+        } else if (tag == "C") {
+            item.type = WORK_STATS;
+            appendItem(items, count, capacity, item);
+        } else if (tag == "R") {
+            int key;
+            fields >> key;
+            item.type = WORK_SORT;
+            item.course = (unsigned char)(key == 1 ? 1 : 0);
+            ok = !fields.fail();
+            if (ok) {
+                appendItem(items, count, capacity, item);
+            }
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            badLines++;
+        }
+    }
+    if (batch->rows > 0) {
+        flushRosterBatch(*batch, roster, badLines);
+    }
+    delete batch;
+    return true;
+}
+
+// Run one operation, folding its result into the checksum
+static void runItem(const WorkItem& item, Roster& roster, int* order,
+                    unsigned long long& checksum) {
+    switch (item.type) {
+        case WORK_QUERY: {
+            int slot = roster.findByPackedId(item.id);
+            mixChecksum(checksum, slot >= 0 ? doubleBits(roster.at(slot).getAvgScore()) : ~0ULL);
+            break;
+        }
+        case WORK_MODIFY: {
+            int slot = roster.findByPackedId(item.id);
+            if (slot >= 0 && item.course < roster.at(slot).getCourseCount()) {
+                Student& s = roster.at(slot);
+                s.setScore(item.course, item.score);
+                mixChecksum(checksum, doubleBits(s.calcAverage()));
+            } else {
+                mixChecksum(checksum, ~0ULL);
+            }
+            break;
+        }
+        case WORK_STATS: {
+            // Course totals, 3-course students first and then 5-course
+            // students, so the checksum does not depend on the mix order
+            RosterView students(roster);
+            double sum[5] = {0, 0, 0, 0, 0};
+            for (int n = 3; n <= 5; n += 2) {
+                for (int i = 0; i < students.size(); i++) {
+                    const Student& s = students.at(i);
+                    if (s.getCourseCount() == n) {
+                        for (int c = 0; c < n; c++) {
+                            sum[c] += s.getScore(c);
+                        }
+                    }
+                }
+            }
+            for (int c = 0; c < 5; c++) {
+                mixChecksum(checksum, doubleBits(sum[c]));
+            }
+            break;
+        }
+        case WORK_SORT: {
+            RosterView students(roster);
+            const Student* const* list = students.data();
+            int n = students.size();
+            for (int i = 0; i < n; i++) {
+                order[i] = i;
+            }
+            // Ties are broken by position so every run gives the same order
+            if (item.course == 1) {
+                sort(order, order + n, [list](int a, int b) {
+                    double x = list[a]->getAvgScore();
+                    double y = list[b]->getAvgScore();
+                    return x != y ? x < y : a < b;
+                });
+            } else {
+                sort(order, order + n, [list](int a, int b) {
+                    return list[a]->getStudentId() < list[b]->getStudentId();
+                });
+            }
+            if (n > 0) {
+                mixChecksum(checksum, (unsigned long long)order[0]);
+                mixChecksum(checksum, (unsigned long long)order[n - 1]);
+            }
+            break;
+        }
+    }
+}
+
+// Latency at fraction q of a sorted array (nearest rank), in microseconds
+static double percentile(const long long* sorted, long long n, double q) {
+    if (n == 0) {
+        return 0.0;
+    }
+    long long rank = (long long)ceil(q * n);
+    if (rank < 1) {
+        rank = 1;
+    }
+    return sorted[rank - 1] / 1000.0;
+}
+
+// Load a trace and run its operations
+bool replayWorkload(const string& fileName, double ratePerSecond, ReplayReport& report) {
+    memset(&report, 0, sizeof(report));
+
+    // Synthetic changes are not published to the change feed or audit log
+    ChangeFeedMute mute;
+    AuditMute auditMute;
+    Roster roster;
+    WorkItem* items = nullptr;
+    long long count = 0;
+    chrono::steady_clock::time_point loadStart = chrono::steady_clock::now();
+    if (!loadTrace(fileName, roster, items, count, report.badLines)) {
+        return false;
+    }
+    report.loadMillis = chrono::duration<double, milli>(chrono::steady_clock::now() - loadStart).count();
+    report.students = roster.size();
+    report.operations = count;
+
+    long long* latencies[WORK_OP_TYPES];
+    for (long long i = 0; i < count; i++) {
+        report.counts[items[i].type]++;
+    }
+    for (int t = 0; t < WORK_OP_TYPES; t++) {
+        latencies[t] = new long long[report.counts[t] > 0 ? report.counts[t] : 1];
+    }
+    long long filled[WORK_OP_TYPES] = {0, 0, 0, 0};
+    int* order = new int[report.students > 0 ? report.students : 1];
+
+    unsigned long long checksum = 14695981039346656037ULL;
+    double intervalNanos = ratePerSecond > 0 ? 1e9 / ratePerSecond : 0.0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (long long i = 0; i < count; i++) {
+        chrono::steady_clock::time_point begin;
+        if (ratePerSecond > 0) {
+            // On schedule: wait and time the operation itself. Behind
+            // schedule: the time spent waiting counts as latency.
+            begin = start + chrono::nanoseconds((long long)(i * intervalNanos));
+            if (chrono::steady_clock::now() < begin) {
+                this_thread::sleep_until(begin);
+                begin = chrono::steady_clock::now();
+            }
+        } else {
+            begin = chrono::steady_clock::now();
+        }
+        runItem(items[i], roster, order, checksum);
+        int type = items[i].type;
+        latencies[type][filled[type]++] = chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now() - begin).count();
+    }
+    report.totalSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    report.checksum = checksum;
+
+    for (int t = 0; t < WORK_OP_TYPES; t++) {
+        long long n = report.counts[t];
+        sort(latencies[t], latencies[t] + n);
+        report.p50[t] = percentile(latencies[t], n, 0.50);
+        report.p95[t] = percentile(latencies[t], n, 0.95);
+        report.p99[t] = percentile(latencies[t], n, 0.99);
+        report.maxMicros[t] = n > 0 ? latencies[t][n - 1] / 1000.0 : 0.0;
+        delete[] latencies[t];
+    }
+    delete[] order;
+    delete[] items;
+    return true;
+}
+
+// Name of an operation type
+string workloadOpName(int op) {
+    switch (op) {
+        case WORK_QUERY:
+            return "Query";
+        case WORK_MODIFY:
+            return "Modify";
+        case WORK_STATS:
+            return "Stats";
+        case WORK_SORT:
+            return "Sort";
+    }
+    return "Unknown";
+}
@@ -0,0 +1,96 @@
+// Workload.h - Seeded workload generator and replay harness
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <string>
+
+using namespace std;
+
+// Operation types of a trace
+enum WorkloadOp {
+    WORK_QUERY = 0,              // look up a student by ID
+    WORK_MODIFY = 1,             // change one course score
+    WORK_STATS = 2,              // per-course statistics over the roster
+    WORK_SORT = 3,               // rank the roster by ID or average
+    WORK_OP_TYPES = 4
+};
+
+// splitmix64: small, fast generator whose sequence depends only on the seed
+class SplitMix64 {
+private:
+    unsigned long long state;
+
+public:
+    SplitMix64(unsigned long long seed);
+
+    unsigned long long next();
+
+    // Uniform in [0, bound)
+    unsigned long long nextBelow(unsigned long long bound);
+
+    // Uniform in [0, 1) with 53 random bits
+    double nextDouble();
+};
+
+// Zipfian ranks in [0, n): rank 0 is the most popular (Gray et al., as
+// used by YCSB). theta must be in (0, 1); 0.99 gives a strong hot set.
+class ZipfSampler {
+private:
+    int n;
+    double theta;
+    double zetaN;
+    double alpha;
+    double eta;
+    double halfPowTheta;
+
+public:
+    ZipfSampler(int count, double skew);
+
+    int sample(SplitMix64& rng) const;
+};
+
+// What to generate
+struct WorkloadConfig {
+    unsigned long long seed;
+    int students;
+    long long operations;
+    int fiveCoursePercent;       // 5-course students, the rest take 3 courses
+    int mix[WORK_OP_TYPES];      // per-mille of each operation type
+    double zipfTheta;            // skew of the student IDs operations touch
+};
+
+// Default configuration: 100000 students, 100000 operations,
+// 80% queries, 19.7% modifications, 0.2% statistics, 0.1% sorts, 60% of
+// the students with 5 courses, Zipf skew 0.99
+void defaultWorkloadConfig(WorkloadConfig& config);
+
+// Write a roster and an operation trace to a text file. The same
+// configuration always produces the same file.
+bool generateWorkload(const WorkloadConfig& config, const string& fileName);
+
+// Results of a replay
+struct ReplayReport {
+    int students;
+    long long operations;
+    long long badLines;
+    double loadMillis;           // filling the roster from the trace
+    double totalSeconds;         // running the operations
+    long long counts[WORK_OP_TYPES];
+    double p50[WORK_OP_TYPES];   // latency percentiles in microseconds
+    double p95[WORK_OP_TYPES];
+    double p99[WORK_OP_TYPES];
+    double maxMicros[WORK_OP_TYPES];
+    unsigned long long checksum; // hash of every operation result
+};
+
+// Load the roster of a trace into a fresh roster and run its operations
+// through the roster APIs. ratePerSecond = 0 runs flat out; otherwise
+// operations start on a fixed schedule. Once the replay falls behind,
+// latency is measured from the scheduled start, so a backlog shows up in
+// the percentiles.
+bool replayWorkload(const string& fileName, double ratePerSecond, ReplayReport& report);
+
+// Name of an operation type
+string workloadOpName(int op);
+
+#endif // WORKLOAD_H
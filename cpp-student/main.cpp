@@ -1,9 +1,68 @@
 // main.cpp - Main function with menu system
 #include "Student.h"
+#include "Archive.h"
+#include "PagedRoster.h"
+#include "StudentT.h"
+#include "ChangeFeed.h"
+#include "Enrollment.h"
+#include "Validate.h"
+#include "AsyncWriter.h"
+#include "Roster.h"
+#include "ScoreJoin.h"
+#include "Snapshot.h"
+#include "AuditLog.h"
+#include "CompactRoster.h"
+#include "Workload.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
 
 // Global variables
-Student* students = nullptr;
-int studentCount = 0;
+Roster roster;
+
+// Compact storage (data tools 19): while compactMode is set the students
+// live only in compactRoster and the roster is empty
+CompactRoster compactRoster;
+bool compactMode = false;
+
+// Change notifications (overwrite oldest so the menu never waits)
+ChangeFeed changeFeed(1024, OVERWRITE_OLDEST);
+ChangeSubscriber changeLog(&changeFeed);
+
+// Background writer for archives, exports and logs
+AsyncWriter ioWriter(2);
+
+// Snapshot given with --snapshot, loaded into the roster in the background
+Snapshot snapshot;
+
+// Audit trail of grade changes (--audit file, --operator name)
+AuditLog auditLog;
+
+// Dump (archive, snapshot or CSV) encoded on its own thread from the live
+// students, see startDump()
+thread dumpThread;
+atomic<bool> dumpFinished(false);
+bool dumpOk = true;
+string dumpFileName;
+
+// Course statistics matrix, kept between calls and rebuilt only when the
+// roster version has changed
+CourseCatalog statsCatalog;
+EnrollmentMatrix statsMatrix;
+unsigned long long statsVersion = 0;
+bool statsBuilt = false;
+
+// Startup phases: name and end time in milliseconds since main() started
+const int MAX_STARTUP_PHASES = 8;
+string startupPhaseNames[MAX_STARTUP_PHASES];
+double startupPhaseEnds[MAX_STARTUP_PHASES];
+int startupPhaseCount = 0;
+chrono::steady_clock::time_point startupTime;
 
 // Helper function to clear cin error state
 void clearInput() {
@@ -26,65 +85,349 @@ void modifyStudent();
 void modifySingleScore();
 void showCourseStats();
 void sortAndDisplay();
+void dataToolsMenu();
+void removeStudent();
+
+// Commands that change students or read Student objects need full storage
+bool requireFullStorage() {
+    if (compactMode) {
+        cout << "Error: Students are in compact storage, switch back to full storage first (data tools 19)!" << endl;
+        return false;
+    }
+    return true;
+}
 
 // Check if student ID already exists
-bool isIdDuplicate(const string& id, int currentIndex) {
-    for (int i = 0; i < currentIndex; i++) {
-        if (students[i].getStudentId() == id) {
-            return true;
+bool isIdDuplicate(const string& id) {
+    return roster.findById(id) >= 0;
+}
+
+// Record the end of a startup phase
+void markStartupPhase(const string& name) {
+    if (startupPhaseCount < MAX_STARTUP_PHASES) {
+        startupPhaseNames[startupPhaseCount] = name;
+        startupPhaseEnds[startupPhaseCount] = chrono::duration<double, milli>(
+            chrono::steady_clock::now() - startupTime).count();
+        startupPhaseCount++;
+    }
+}
+
+// Show how long each startup phase took
+void showStartupTiming() {
+    cout << "\n--- Startup Timing ---" << endl;
+    double previous = 0;
+    for (int i = 0; i < startupPhaseCount; i++) {
+        cout << "  " << startupPhaseNames[i] << ": " << (startupPhaseEnds[i] - previous)
+             << " ms (at " << startupPhaseEnds[i] << " ms)" << endl;
+        previous = startupPhaseEnds[i];
+    }
+    if (snapshot.isOpen()) {
+        if (snapshot.isLoaded()) {
+            cout << "  Background roster load: " << snapshot.getLoadMillis() << " ms for "
+                 << snapshot.getLoadedCount() << " students" << endl;
+        } else {
+            cout << "  Background roster load: in progress (" << snapshot.getLoadedCount()
+                 << " of " << snapshot.size() << " students)" << endl;
+        }
+        cout << "  Lookups served from the snapshot file: " << snapshot.getLookups() << endl;
+    }
+}
+
+// Wait until the background snapshot load has filled the roster
+void waitForRoster() {
+    if (!snapshot.isLoading()) {
+        return;
+    }
+    if (!snapshot.isLoaded()) {
+        cout << "Loading roster from snapshot (" << snapshot.getLoadedCount() << " of "
+             << snapshot.size() << " students)..." << endl;
+    }
+    if (!snapshot.waitLoaded()) {
+        cout << "Error: Snapshot file could not be read completely!" << endl;
+    }
+}
+
+// True when the roster can be used without waiting
+bool rosterReady() {
+    if (snapshot.isLoading() && snapshot.isLoaded()) {
+        waitForRoster();
+    }
+    return !snapshot.isLoading();
+}
+
+// Open a file on the background writer. The open runs on a writer
+// thread; wait for it so a bad path is reported now. -1 on error.
+int openOutputFile(const string& fileName) {
+    int handle = ioWriter.openFile(fileName, false);
+    if (handle < 0) {
+        cout << "Error: Too many files are being written!" << endl;
+        return -1;
+    }
+    if (!ioWriter.waitFile(handle)) {
+        ioWriter.closeFile(handle);
+        cout << "Error: Cannot open " << fileName << " for writing!" << endl;
+        return -1;
+    }
+    return handle;
+}
+
+// Wait until the dump thread has queued all its data, and report a dump
+// that could not be encoded
+void waitForDump() {
+    if (!dumpThread.joinable()) {
+        return;
+    }
+    dumpThread.join();
+    if (!dumpOk) {
+        cout << "\nWarning: background write of " << dumpFileName << " failed!" << endl;
+    }
+}
+
+// Encoder run by the dump thread on a file opened with ioWriter.openFile()
+typedef bool (*DumpEncoder)(AsyncWriter& writer, int handle, const Student* const* list, int count);
+
+// True while a dump thread may still read the roster
+bool dumpRunning() {
+    return dumpThread.joinable();
+}
+
+// Start a dump: the menu thread opens the file, the dump thread encodes
+// the live students and queues the data on ioWriter. Encoding blocks once
+// the writer's buffer pool is full, so it must not run on the menu thread.
+// The students are read in place, so until the dump is waited for, commands
+// that change the roster call waitForDump() first and compaction is paused.
+// One dump runs at a time.
+bool startDump(const string& fileName, DumpEncoder encode) {
+    waitForDump();
+    int handle = openOutputFile(fileName);
+    if (handle < 0) {
+        return false;
+    }
+    RosterView* students = new RosterView(roster);
+    dumpFileName = fileName;
+    dumpOk = true;
+    dumpFinished.store(false);
+    dumpThread = thread([handle, students, encode]() {
+        dumpOk = encode(ioWriter, handle, students->data(), students->size());
+        ioWriter.closeFile(handle);
+        delete students;
+        dumpFinished.store(true, memory_order_release);
+    });
+    return true;
+}
+
+// Report background writes that failed since the last menu
+void reportFailedWrites() {
+    if (dumpFinished.load(memory_order_acquire)) {
+        waitForDump();
+    }
+    string names[ASYNC_MAX_FAILED];
+    int n = ioWriter.takeFailedFiles(names, ASYNC_MAX_FAILED);
+    for (int i = 0; i < n; i++) {
+        cout << "\nWarning: background write of " << names[i] << " failed!" << endl;
+    }
+}
+
+// Parse a non-negative whole number given on the command line, false if
+// it is not a number or does not fit in 64 bits
+bool parseCountArg(const string& text, unsigned long long& value) {
+    // strtoull would accept a sign and negate the value
+    if (text.empty() || text[0] < '0' || text[0] > '9') {
+        return false;
+    }
+    char* end;
+    errno = 0;
+    value = strtoull(text.c_str(), &end, 10);
+    return *end == '\0' && errno != ERANGE;
+}
+
+// Parse a decimal number given on the command line
+bool parseRealArg(const string& text, double& value) {
+    char* end;
+    errno = 0;
+    value = strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0' && errno != ERANGE;
+}
+
+// Parse an operation mix "query,modify,stats,sort" in per-mille (sum 1000)
+bool parseMixArg(const string& text, int* mix) {
+    size_t pos = 0;
+    int total = 0;
+    for (int t = 0; t < WORK_OP_TYPES; t++) {
+        size_t comma = text.find(',', pos);
+        bool lastField = (t == WORK_OP_TYPES - 1);
+        if (lastField != (comma == string::npos)) {
+            return false;
+        }
+        unsigned long long value;
+        string field = lastField ? text.substr(pos) : text.substr(pos, comma - pos);
+        if (!parseCountArg(field, value) || value > 1000) {
+            return false;
+        }
+        mix[t] = (int)value;
+        total += mix[t];
+        pos = comma + 1;
+    }
+    return total == 1000;
+}
+
+// Write a generated roster and operation trace (--generate)
+int generateTrace(const WorkloadConfig& config, const string& fileName) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    if (!generateWorkload(config, fileName)) {
+        cout << "Error: Cannot write workload file " << fileName << endl;
+        return 1;
+    }
+    cout << "Generated " << config.students << " students and " << config.operations
+         << " operations (seed " << config.seed << ") into " << fileName << " in "
+         << chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count()
+         << " ms." << endl;
+    return 0;
+}
+
+// Replay a trace and report throughput and latency percentiles (--replay)
+int replayTrace(const string& fileName, double rate) {
+    ReplayReport report;
+    if (!replayWorkload(fileName, rate, report)) {
+        cout << "Error: Cannot read workload file " << fileName << endl;
+        return 1;
+    }
+    cout << "\n--- Replay Report ---" << endl;
+    cout << "Students loaded : " << report.students << " (" << report.loadMillis << " ms)" << endl;
+    if (report.badLines > 0) {
+        cout << "Skipped lines   : " << report.badLines << endl;
+    }
+    cout << "Operations      : " << report.operations << " in " << report.totalSeconds << " s";
+    if (report.totalSeconds > 0) {
+        cout << " (" << (long long)(report.operations / report.totalSeconds) << " ops/s";
+        cout << (rate > 0 ? ", target " : "") ;
+        if (rate > 0) {
+            cout << (long long)rate;
+        }
+        cout << ")";
+    }
+    cout << endl;
+    cout << "\nType\tCount\tp50 us\tp95 us\tp99 us\tMax us" << endl;
+    cout << "------------------------------------------------------------" << endl;
+    for (int t = 0; t < WORK_OP_TYPES; t++) {
+        if (report.counts[t] == 0) {
+            continue;
         }
+        cout << workloadOpName(t) << "\t" << report.counts[t] << "\t" << report.p50[t] << "\t"
+             << report.p95[t] << "\t" << report.p99[t] << "\t" << report.maxMicros[t] << endl;
     }
-    return false;
+    cout << "\nResult checksum : " << hex << report.checksum << dec << endl;
+    return 0;
 }
 
 // Main function
-int main() {
+int main(int argc, char* argv[]) {
+    startupTime = chrono::steady_clock::now();
     int choice;
+    string snapshotFile;
+    string auditFile = "grades.audit";
+    string operatorName = "console";
+    string generateFile;
+    string replayFile;
+    unsigned long long rate = 0;
+    WorkloadConfig workload;
+    defaultWorkloadConfig(workload);
     
-    cout << "============================================" << endl;
-    cout << "    Welcome to Student Management System    " << endl;
-    cout << "============================================" << endl;
-    
-    // Input number of students
-    while (true) {
-        cout << "\nPlease enter the number of students (1-100): " << flush;
-        cin >> studentCount;
-        if (cin.fail()) {
-            clearInput();
-            cout << "Error: Please enter a valid number!" << endl;
-            continue;
-        }
-        if (studentCount <= 0) {
-            cout << "Error: Number must be positive!" << endl;
-            continue;
+    // Command line options
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        unsigned long long value = 0;
+        bool ok = true;
+        if (arg == "--snapshot" && i + 1 < argc) {
+            snapshotFile = argv[++i];
+        } else if (arg == "--audit" && i + 1 < argc) {
+            auditFile = argv[++i];
+        } else if (arg == "--operator" && i + 1 < argc) {
+            operatorName = argv[++i];
+        } else if (arg == "--generate" && i + 1 < argc) {
+            generateFile = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayFile = argv[++i];
+        } else if (arg == "--seed" && i + 1 < argc) {
+            ok = parseCountArg(argv[++i], value);
+            workload.seed = value;
+        } else if (arg == "--students" && i + 1 < argc) {
+            ok = parseCountArg(argv[++i], value) && value >= 1 && value <= 10000000;
+            workload.students = (int)value;
+        } else if (arg == "--operations" && i + 1 < argc) {
+            ok = parseCountArg(argv[++i], value) && value <= (unsigned long long)LLONG_MAX;
+            workload.operations = (long long)value;
+        } else if (arg == "--five-percent" && i + 1 < argc) {
+            ok = parseCountArg(argv[++i], value) && value <= 100;
+            workload.fiveCoursePercent = (int)value;
+        } else if (arg == "--mix" && i + 1 < argc) {
+            ok = parseMixArg(argv[++i], workload.mix);
+        } else if (arg == "--theta" && i + 1 < argc) {
+            // The Zipf sampler needs theta strictly between 0 and 1
+            ok = parseRealArg(argv[++i], workload.zipfTheta)
+                 && workload.zipfTheta > 0.0 && workload.zipfTheta < 1.0;
+        } else if (arg == "--rate" && i + 1 < argc) {
+            ok = parseCountArg(argv[++i], rate);
+        } else {
+            ok = false;
         }
-        if (studentCount > 100) {
-            cout << "Error: Maximum 100 students allowed!" << endl;
-            continue;
+        if (!ok) {
+            cout << "Usage: " << argv[0]
+                 << " [--snapshot file] [--audit file] [--operator name]" << endl;
+            cout << "       " << argv[0]
+                 << " --generate file [--seed n] [--students n] [--operations n]" << endl;
+            cout << "                [--mix query,modify,stats,sort (per-mille, sum 1000)]"
+                 << " [--theta 0..1] [--five-percent 0..100]" << endl;
+            cout << "       " << argv[0] << " --replay file [--rate ops-per-second]" << endl;
+            return 1;
         }
-        break;
     }
     
-    // Dynamically allocate memory for students
-    students = new Student[studentCount];
+    // Workload tools run without the interactive menu
+    if (!generateFile.empty()) {
+        return generateTrace(workload, generateFile);
+    }
+    if (!replayFile.empty()) {
+        return replayTrace(replayFile, (double)rate);
+    }
     
-    // Input all students information
-    cout << "\n--- Please enter information for " << studentCount << " students ---" << endl;
-    for (int i = 0; i < studentCount; i++) {
-        cout << "\n>>> Entering information for Student " << (i + 1) << " <<<" << endl;
-        while (true) {
-            students[i].inputInfo();
-            // Check for duplicate student ID
-            if (isIdDuplicate(students[i].getStudentId(), i)) {
-                cout << "Error: Student ID already exists! Please enter again." << endl;
-                continue;
-            }
-            break;
+    setChangeFeed(&changeFeed);
+    if (!changeLog.isRegistered()) {
+        cout << "Warning: Change feed is full, recent changes are not shown!" << endl;
+    }
+    if (auditLog.open(ioWriter, auditFile, operatorName)) {
+        setAuditLog(&auditLog);
+    } else {
+        cout << "Warning: Cannot open audit log " << auditFile
+             << ", grade changes are not audited!" << endl;
+    }
+    
+    cout << "============================================" << endl;
+    cout << "    Welcome to Student Management System    " << endl;
+    cout << "============================================" << endl;
+    
+    if (!snapshotFile.empty()) {
+        // Fast start: lookups by ID are served from the file at once,
+        // the roster is filled in the background
+        if (!snapshot.open(snapshotFile)) {
+            cout << "Error: Cannot open snapshot file " << snapshotFile << endl;
+            return 1;
         }
+        markStartupPhase("Open snapshot and read ID fences");
+        snapshot.startLoad(roster);
+        markStartupPhase("Start background roster load");
+        cout << "\nSnapshot of " << snapshot.size()
+             << " students opened, loading the roster in the background." << endl;
+        markStartupPhase("Ready");
+        showStartupTiming();
+    } else {
+        inputStudents();
+        markStartupPhase("Keyboard input");
     }
     
     // Main menu loop
     while (true) {
+        reportFailedWrites();
         showMainMenu();
         cout << "Please enter your choice: " << flush;
         cin >> choice;
@@ -95,6 +438,20 @@ int main() {
             continue;
         }
         
+        // Everything except queries needs the fully loaded roster
+        if (choice != 2) {
+            waitForRoster();
+        }
+        
+        // A running dump reads the live students: commands that change
+        // them wait for it (data tools commands wait where they write)
+        if (choice == 3 || choice == 4 || choice == 8) {
+            waitForDump();
+            if (!requireFullStorage()) {
+                continue;
+            }
+        }
+        
         switch (choice) {
             case 1:
                 showAllStudents();
@@ -114,22 +471,91 @@ int main() {
             case 6:
                 sortAndDisplay();
                 break;
+            case 7:
+                dataToolsMenu();
+                break;
+            case 8:
+                removeStudent();
+                break;
             case 0:
                 cout << "\nExiting program..." << endl;
+                // A dump still being encoded finishes first
+                waitForDump();
                 // Release memory - destructor will be called
-                delete[] students;
-                students = nullptr;
+                roster.clear();
+                auditLog.close();
                 cout << "Thank you for using Student Management System!" << endl;
                 cout << "This program is written by Zhang San" << endl;
                 return 0;
             default:
                 cout << "Invalid choice! Please try again." << endl;
         }
+        
+        // Grade changes of this command go to the audit log as one block
+        auditLog.sealPending();
+        
+        // Reclaim slots of removed students, at most about 1ms per command
+        // (not while a dump reads the students in place)
+        if (rosterReady() && !dumpRunning()) {
+            roster.compactStep(1000);
+        }
     }
     
     return 0;
 }
 
+// Input the number of students and their information from the keyboard
+void inputStudents() {
+    int studentCount;
+    
+    // Input number of students
+    while (true) {
+        cout << "\nPlease enter the number of students (1-100): " << flush;
+        cin >> studentCount;
+        if (cin.fail()) {
+            clearInput();
+            cout << "Error: Please enter a valid number!" << endl;
+            continue;
+        }
+        if (studentCount <= 0) {
+            cout << "Error: Number must be positive!" << endl;
+            continue;
+        }
+        if (studentCount > 100) {
+            cout << "Error: Maximum 100 students allowed!" << endl;
+            continue;
+        }
+        break;
+    }
+    
+    // Dynamically allocate memory for students
+    roster.reserve(studentCount);
+    
+    // Input all students information
+    cout << "\n--- Please enter information for " << studentCount << " students ---" << endl;
+    for (int i = 0; i < studentCount; i++) {
+        cout << "\n>>> Entering information for Student " << (i + 1) << " <<<" << endl;
+        Student newStudent;
+        while (true) {
+            {
+                // Fields of a new student are published once as an add,
+                // and its first scores are not grade changes
+                ChangeFeedMute mute;
+                AuditMute auditMute;
+                newStudent.inputInfo();
+            }
+            // Check for duplicate student ID
+            if (isIdDuplicate(newStudent.getStudentId())) {
+                cout << "Error: Student ID already exists! Please enter again." << endl;
+                continue;
+            }
+            break;
+        }
+        roster.add(newStudent);
+        publishStudentChange(CHANGE_ADD, newStudent);
+    }
+}
+
 // Show main menu
 void showMainMenu() {
     cout << "\n============================================" << endl;
@@ -141,6 +567,8 @@ void showMainMenu() {
     cout << "  4. Modify Single Course Score" << endl;
     cout << "  5. Show Course Statistics" << endl;
     cout << "  6. Sort and Display Students" << endl;
+    cout << "  7. File and Data Tools" << endl;
+    cout << "  8. Remove Student" << endl;
     cout << "  0. Exit Program" << endl;
     cout << "============================================" << endl;
 }
@@ -151,9 +579,21 @@ void showAllStudents() {
     cout << "           All Students Information         " << endl;
     cout << "============================================" << endl;
     
-    for (int i = 0; i < studentCount; i++) {
-        cout << "\n--- Student " << (i + 1) << " ---" << endl;
-        students[i].display();
+    if (compactMode) {
+        for (int i = 0; i < compactRoster.size(); i++) {
+            cout << "\n--- Student " << (i + 1) << " ---" << endl;
+            displayCompact(compactRoster.at(i));
+        }
+        return;
+    }
+    
+    int number = 0;
+    for (int i = 0; i < roster.getSlotCount(); i++) {
+        if (!roster.isLive(i)) {
+            continue;
+        }
+        cout << "\n--- Student " << (++number) << " ---" << endl;
+        roster.at(i).display();
     }
 }
 
@@ -181,12 +621,27 @@ void queryStudent() {
         cin >> searchId;
         clearInput();
         
-        for (int i = 0; i < studentCount; i++) {
-            if (students[i].getStudentId() == searchId) {
+        if (compactMode) {
+            int index = isValidId(searchId) ? compactRoster.findById(packStudentId(searchId)) : -1;
+            if (index >= 0) {
                 cout << "\nStudent found!" << endl;
-                students[i].display();
+                displayCompact(compactRoster.at(index));
+                found = true;
+            }
+        } else if (!rosterReady()) {
+            // Served from the snapshot file while the roster is loading
+            Student result;
+            if (snapshot.find(searchId, result)) {
+                cout << "\nStudent found!" << endl;
+                result.display();
+                found = true;
+            }
+        } else {
+            int slot = roster.findById(searchId);
+            if (slot >= 0) {
+                cout << "\nStudent found!" << endl;
+                roster.at(slot).display();
                 found = true;
-                break;
             }
         }
     } else if (choice == 2) {
@@ -194,11 +649,19 @@ void queryStudent() {
         cout << "Enter name to search: " << flush;
         cin >> searchName;
         clearInput();
+        waitForRoster();
         
-        for (int i = 0; i < studentCount; i++) {
-            if (students[i].getName() == searchName) {
+        for (int i = 0; i < compactRoster.size(); i++) {
+            if (compactName(compactRoster.at(i)) == searchName) {
+                cout << "\nStudent found!" << endl;
+                displayCompact(compactRoster.at(i));
+                found = true;
+            }
+        }
+        for (int i = 0; i < roster.getSlotCount(); i++) {
+            if (roster.isLive(i) && roster.at(i).getName() == searchName) {
                 cout << "\nStudent found!" << endl;
-                students[i].display();
+                roster.at(i).display();
                 found = true;
             }
         }
@@ -222,31 +685,22 @@ void modifyStudent() {
     clearInput();
     
     bool found = false;
-    for (int i = 0; i < studentCount; i++) {
-        if (students[i].getStudentId() == searchId) {
-            cout << "\nCurrent student information:" << endl;
-            students[i].display();
-            
-            // Save old ID before modification
-            string oldId = students[i].getStudentId();
-            students[i].modifyInfo();
-            
-            // Check if ID was changed and is now duplicate
-            string newId = students[i].getStudentId();
-            if (newId != oldId) {
-                // Check if new ID duplicates another student
-                for (int j = 0; j < studentCount; j++) {
-                    if (j != i && students[j].getStudentId() == newId) {
-                        cout << "Error: This student ID already exists! Reverting to original ID." << endl;
-                        students[i].setStudentId(oldId);
-                        break;
-                    }
-                }
-            }
-            
-            found = true;
-            break;
+    int i = roster.findById(searchId);
+    if (i >= 0) {
+        Student& current = roster.at(i);
+        cout << "\nCurrent student information:" << endl;
+        current.display();
+        
+        // Save old ID before modification
+        string oldId = current.getStudentId();
+        // A duplicate ID is refused inside modifyInfo, before any change
+        // is made or published
+        current.modifyInfo(isIdDuplicate);
+        if (current.getStudentId() != oldId) {
+            roster.updateIdIndex(i, oldId);
         }
+        
+        found = true;
     }
     
     if (!found) {
@@ -264,51 +718,57 @@ void modifySingleScore() {
     clearInput();
     
     bool found = false;
-    for (int i = 0; i < studentCount; i++) {
-        if (students[i].getStudentId() == searchId) {
-            found = true;
-            cout << "\nStudent found: " << students[i].getName() << endl;
-            cout << "This student has " << students[i].getCourseCount() << " courses." << endl;
-            cout << "Current scores: ";
-            for (int j = 0; j < students[i].getCourseCount(); j++) {
-                cout << "Course" << (j + 1) << ":" << students[i].getScore(j);
-                if (j < students[i].getCourseCount() - 1) cout << ", ";
+    int i = roster.findById(searchId);
+    if (i >= 0) {
+        // The slot is looked up again through the handle after the prompts
+        StudentHandle handle = roster.handleOf(i);
+        const Student& target = roster.at(i);
+        found = true;
+        cout << "\nStudent found: " << target.getName() << endl;
+        cout << "This student has " << target.getCourseCount() << " courses." << endl;
+        cout << "Current scores: ";
+        for (int j = 0; j < target.getCourseCount(); j++) {
+            cout << "Course" << (j + 1) << ":" << target.getScore(j);
+            if (j < target.getCourseCount() - 1) cout << ", ";
+        }
+        cout << endl;
+        
+        int courseIndex;
+        double newScore;
+        
+        while (true) {
+            cout << "Enter course number to modify (1-" << target.getCourseCount() << "): " << flush;
+            cin >> courseIndex;
+            if (cin.fail()) {
+                clearInput();
+                cout << "Error: Please enter a valid number!" << endl;
+                continue;
             }
-            cout << endl;
-            
-            int courseIndex;
-            double newScore;
-            
-            while (true) {
-                cout << "Enter course number to modify (1-" << students[i].getCourseCount() << "): " << flush;
-                cin >> courseIndex;
-                if (cin.fail()) {
-                    clearInput();
-                    cout << "Error: Please enter a valid number!" << endl;
-                    continue;
-                }
-                if (courseIndex >= 1 && courseIndex <= students[i].getCourseCount()) {
-                    break;
-                }
-                cout << "Error: Invalid course number!" << endl;
+            if (courseIndex >= 1 && courseIndex <= target.getCourseCount()) {
+                break;
             }
-            
-            while (true) {
-                cout << "Enter new score (0-100): " << flush;
-                cin >> newScore;
-                if (cin.fail()) {
-                    clearInput();
-                    cout << "Error: Please enter a valid number!" << endl;
-                    continue;
-                }
-                if (students[i].setScore(courseIndex - 1, newScore)) {
-                    students[i].calcAverage();
-                    cout << "Score modified successfully!" << endl;
-                    cout << "New average score: " << students[i].getAvgScore() << endl;
-                    break;
-                }
+            cout << "Error: Invalid course number!" << endl;
+        }
+        
+        while (true) {
+            cout << "Enter new score (0-100): " << flush;
+            cin >> newScore;
+            if (cin.fail()) {
+                clearInput();
+                cout << "Error: Please enter a valid number!" << endl;
+                continue;
+            }
+            if (!roster.resolve(handle, i)) {
+                cout << "Error: Student was removed!" << endl;
+                return;
+            }
+            Student& student = roster.at(i);
+            if (student.setScore(courseIndex - 1, newScore)) {
+                student.calcAverage();
+                cout << "Score modified successfully!" << endl;
+                cout << "New average score: " << student.getAvgScore() << endl;
+                break;
             }
-            break;
         }
     }
     
@@ -317,39 +777,97 @@ void modifySingleScore() {
     }
 }
 
+// Course statistics of the compact storage, computed from the integer
+// scores (same output as the matrix path)
+void showCompactCourseStats() {
+    CourseCatalog catalog;
+    addDefaultCourses(catalog);
+    int columnCount = catalog.getCount();
+    long long* sums = new long long[columnCount];
+    int* highest = new int[columnCount];
+    int* lowest = new int[columnCount];
+    int* counts = new int[columnCount];
+    for (int c = 0; c < columnCount; c++) {
+        sums[c] = 0;
+        highest[c] = 0;
+        lowest[c] = 0;
+        counts[c] = 0;
+    }
+    
+    for (int i = 0; i < compactRoster.size(); i++) {
+        const CompactStudent& student = compactRoster.at(i);
+        int cc = compactCourseCount(student);
+        for (int k = 0; k < cc; k++) {
+            int c = catalog.findCourse(defaultCourseId(cc, k));
+            if (c < 0) {
+                continue;
+            }
+            int score = student.scores[k];
+            if (counts[c] == 0 || score > highest[c]) highest[c] = score;
+            if (counts[c] == 0 || score < lowest[c]) lowest[c] = score;
+            sums[c] += score;
+            counts[c]++;
+        }
+    }
+    
+    for (int c = 0; c < columnCount; c++) {
+        if (counts[c] > 0) {
+            cout << "\nCourse " << catalog.getName(c) << " (ID " << catalog.getCourseId(c) << "):" << endl;
+            cout << "  Average Score : " << ((double)sums[c] / ((double)counts[c] * COMPACT_SCORE_SCALE)) << endl;
+            cout << "  Highest Score : " << ((double)highest[c] / COMPACT_SCORE_SCALE) << endl;
+            cout << "  Lowest Score  : " << ((double)lowest[c] / COMPACT_SCORE_SCALE) << endl;
+            cout << "  Student Count : " << counts[c] << endl;
+        }
+    }
+    delete[] sums;
+    delete[] highest;
+    delete[] lowest;
+    delete[] counts;
+    
+    cout << "\n--- Students with Failed Courses ---" << endl;
+    bool hasFailedStudents = false;
+    for (int i = 0; i < compactRoster.size(); i++) {
+        const CompactStudent& student = compactRoster.at(i);
+        if (compactHasFailedCourse(student)) {
+            cout << "ID: " << unpackStudentId(compactId(student))
+                 << ", Name: " << compactName(student) << endl;
+            hasFailedStudents = true;
+        }
+    }
+    if (!hasFailedStudents) {
+        cout << "No student has failed courses." << endl;
+    }
+}
+
 // Show course statistics
 void showCourseStats() {
     cout << "\n============================================" << endl;
     cout << "           Course Statistics                " << endl;
     cout << "============================================" << endl;
     
-    // Find max course count
-    int maxCourses = 0;
-    for (int i = 0; i < studentCount; i++) {
-        if (students[i].getCourseCount() > maxCourses) {
-            maxCourses = students[i].getCourseCount();
-        }
+    if (compactMode) {
+        showCompactCourseStats();
+        return;
     }
     
-    // Calculate statistics for each course
-    for (int c = 0; c < maxCourses; c++) {
-        double sum = 0;
-        double maxScore = -1;
-        double minScore = 101;
-        int count = 0;
-        
-        for (int i = 0; i < studentCount; i++) {
-            if (c < students[i].getCourseCount()) {
-                double score = students[i].getScore(c);
-                sum += score;
-                count++;
-                if (score > maxScore) maxScore = score;
-                if (score < minScore) minScore = score;
-            }
-        }
-        
+    // Scores by catalog course (5-course and 3-course students take different courses)
+    // Bulk scan over the live slots (a pending compaction is left alone)
+    RosterView students(roster);
+    int studentCount = students.size();
+    if (!statsBuilt || statsVersion != roster.getVersion()) {
+        statsMatrix.buildFromRoster(students.data(), studentCount, statsCatalog);
+        statsVersion = roster.getVersion();
+        statsBuilt = true;
+    }
+    
+    // Show statistics for each course, scanning only enrolled students
+    for (int c = 0; c < statsCatalog.getCount(); c++) {
+        double sum;
+        double maxScore;
+        double minScore;
+        int count = statsMatrix.courseStats(c, sum, maxScore, minScore);
         if (count > 0) {
-            cout << "\nCourse " << (c + 1) << ":" << endl;
+            cout << "\nCourse " << statsCatalog.getName(c) << " (ID " << statsCatalog.getCourseId(c) << "):" << endl;
             cout << "  Average Score : " << (sum / count) << endl;
             cout << "  Highest Score : " << maxScore << endl;
             cout << "  Lowest Score  : " << minScore << endl;
@@ -357,13 +875,13 @@ void showCourseStats() {
         }
     }
     
-    // Show students with failed courses
+    // Show students with failed courses (checked in place, no second copy)
     cout << "\n--- Students with Failed Courses ---" << endl;
     bool hasFailedStudents = false;
     for (int i = 0; i < studentCount; i++) {
-        if (students[i].hasFailedCourse()) {
-            cout << "ID: " << students[i].getStudentId() 
-                 << ", Name: " << students[i].getName() << endl;
+        if (students.at(i).hasFailedCourse()) {
+            cout << "ID: " << students.at(i).getStudentId() 
+                 << ", Name: " << students.at(i).getName() << endl;
             hasFailedStudents = true;
         }
     }
@@ -372,6 +890,21 @@ void showCourseStats() {
     }
 }
 
+// Sort comparisons on a roster slot, or a compact position in compact mode
+bool sortIdGreater(int a, int b) {
+    if (compactMode) {
+        return compactId(compactRoster.at(a)) > compactId(compactRoster.at(b));
+    }
+    return roster.at(a).getStudentId() > roster.at(b).getStudentId();
+}
+
+bool sortAverageGreater(int a, int b) {
+    if (compactMode) {
+        return compactAverage(compactRoster.at(a)) > compactAverage(compactRoster.at(b));
+    }
+    return roster.at(a).getAvgScore() > roster.at(b).getAvgScore();
+}
+
 // Sort and display
 void sortAndDisplay() {
     cout << "\n--- Sort and Display Students ---" << endl;
@@ -390,10 +923,19 @@ void sortAndDisplay() {
         return;
     }
     
-    // Create index array for sorting (avoid copying Student objects)
-    int* indices = new int[studentCount];
-    for (int i = 0; i < studentCount; i++) {
-        indices[i] = i;
+    // Create index array of live slots for sorting (avoid copying Student objects)
+    int studentCount = compactMode ? compactRoster.size() : roster.size();
+    int* indices = new int[studentCount > 0 ? studentCount : 1];
+    int n = 0;
+    if (compactMode) {
+        for (int i = 0; i < studentCount; i++) {
+            indices[n++] = i;
+        }
+    }
+    for (int i = 0; i < roster.getSlotCount(); i++) {
+        if (roster.isLive(i)) {
+            indices[n++] = i;
+        }
     }
     
     switch (choice) {
@@ -401,7 +943,7 @@ void sortAndDisplay() {
             // Sort by ID ascending
             for (int i = 0; i < studentCount - 1; i++) {
                 for (int j = 0; j < studentCount - 1 - i; j++) {
-                    if (students[indices[j]].getStudentId() > students[indices[j + 1]].getStudentId()) {
+                    if (sortIdGreater(indices[j], indices[j + 1])) {
                         int temp = indices[j];
                         indices[j] = indices[j + 1];
                         indices[j + 1] = temp;
@@ -414,7 +956,7 @@ void sortAndDisplay() {
             // Sort by ID descending
             for (int i = 0; i < studentCount - 1; i++) {
                 for (int j = 0; j < studentCount - 1 - i; j++) {
-                    if (students[indices[j]].getStudentId() < students[indices[j + 1]].getStudentId()) {
+                    if (sortIdGreater(indices[j + 1], indices[j])) {
                         int temp = indices[j];
                         indices[j] = indices[j + 1];
                         indices[j + 1] = temp;
@@ -427,7 +969,7 @@ void sortAndDisplay() {
             // Sort by average ascending
             for (int i = 0; i < studentCount - 1; i++) {
                 for (int j = 0; j < studentCount - 1 - i; j++) {
-                    if (students[indices[j]].getAvgScore() > students[indices[j + 1]].getAvgScore()) {
+                    if (sortAverageGreater(indices[j], indices[j + 1])) {
                         int temp = indices[j];
                         indices[j] = indices[j + 1];
                         indices[j + 1] = temp;
@@ -440,7 +982,7 @@ void sortAndDisplay() {
             // Sort by average descending
             for (int i = 0; i < studentCount - 1; i++) {
                 for (int j = 0; j < studentCount - 1 - i; j++) {
-                    if (students[indices[j]].getAvgScore() < students[indices[j + 1]].getAvgScore()) {
+                    if (sortAverageGreater(indices[j + 1], indices[j])) {
                         int temp = indices[j];
                         indices[j] = indices[j + 1];
                         indices[j + 1] = temp;
@@ -459,14 +1001,779 @@ void sortAndDisplay() {
     cout << "\nRank\tStudent ID\tName\t\tGender\tAverage" << endl;
     cout << "------------------------------------------------------------" << endl;
     for (int i = 0; i < studentCount; i++) {
+        if (compactMode) {
+            const CompactStudent& c = compactRoster.at(indices[i]);
+            cout << (i + 1) << "\t"
+                 << unpackStudentId(compactId(c)) << "\t"
+                 << compactName(c) << "\t\t"
+                 << compactGender(c) << "\t"
+                 << compactAverage(c) << endl;
+            continue;
+        }
         cout << (i + 1) << "\t" 
-             << students[indices[i]].getStudentId() << "\t" 
-             << students[indices[i]].getName() << "\t\t" 
-             << students[indices[i]].getGender() << "\t" 
-             << students[indices[i]].getAvgScore() << endl;
+             << roster.at(indices[i]).getStudentId() << "\t" 
+             << roster.at(indices[i]).getName() << "\t\t" 
+             << roster.at(indices[i]).getGender() << "\t" 
+             << roster.at(indices[i]).getAvgScore() << endl;
     }
     cout << "------------------------------------------------------------" << endl;
     
     delete[] indices;
 }
 
+// Save current roster to an archive file (written in the background)
+void saveArchive() {
+    string fileName;
+    cout << "Enter archive file name: " << flush;
+    cin >> fileName;
+    clearInput();
+    if (startDump(fileName, writeArchive)) {
+        cout << "Archive of " << roster.size() << " students is being written in the background." << endl;
+    }
+}
+
+// Query an archive by student ID
+void queryArchiveId() {
+    string fileName;
+    string searchId;
+    cout << "Enter archive file name: " << flush;
+    cin >> fileName;
+    clearInput();
+    // Archives saved in the background must be complete before reading
+    waitForDump();
+    ioWriter.drain();
+    cout << "Enter student ID to search: " << flush;
+    cin >> searchId;
+    clearInput();
+
+    Student result;
+    int blocksRead = 0;
+    if (findInArchive(fileName, searchId, result, blocksRead)) {
+        cout << "\nStudent found! (blocks decoded: " << blocksRead << ")" << endl;
+        result.display();
+    } else {
+        cout << "No student found in archive (blocks decoded: " << blocksRead << ")" << endl;
+    }
+}
+
+// Query an archive by average score range
+void queryArchiveAverage() {
+    string fileName;
+    double low;
+    double high;
+    cout << "Enter archive file name: " << flush;
+    cin >> fileName;
+    clearInput();
+    // Archives saved in the background must be complete before reading
+    waitForDump();
+    ioWriter.drain();
+    cout << "Enter lowest and highest average (e.g. 60 80): " << flush;
+    cin >> low >> high;
+    if (cin.fail()) {
+        clearInput();
+        cout << "Error: Please enter valid numbers!" << endl;
+        return;
+    }
+
+    Student* results = nullptr;
+    int blocksRead = 0;
+    int found = queryArchiveByAverage(fileName, low, high, results, blocksRead);
+    if (found < 0) {
+        cout << "Error: Cannot read archive file!" << endl;
+        return;
+    }
+    cout << "\nStudent ID\tName\tGender\tAverage" << endl;
+    for (int i = 0; i < found; i++) {
+        results[i].displayBrief();
+    }
+    cout << found << " students found (blocks decoded: " << blocksRead << ")" << endl;
+    delete[] results;
+}
+
+// Show the block index of an archive
+void showArchiveIndex() {
+    string fileName;
+    cout << "Enter archive file name: " << flush;
+    cin >> fileName;
+    clearInput();
+    // Archives saved in the background must be complete before reading
+    waitForDump();
+    ioWriter.drain();
+
+    ArchiveBlockInfo* blocks = nullptr;
+    int blockCount = 0;
+    int totalCount = 0;
+    if (!readArchiveIndex(fileName, blocks, blockCount, totalCount)) {
+        cout << "Error: Cannot read archive file!" << endl;
+        return;
+    }
+    long long bytes = 0;
+    cout << "\nBlock\tCount\tBytes\tMin ID\t\tMax ID\t\tAvg Range" << endl;
+    for (int b = 0; b < blockCount; b++) {
+        bytes += blocks[b].payloadBytes;
+        cout << (b + 1) << "\t" << blocks[b].count << "\t" << blocks[b].payloadBytes << "\t"
+             << unpackStudentId(blocks[b].minId) << "\t" << unpackStudentId(blocks[b].maxId) << "\t"
+             << blocks[b].minAvg << "-" << blocks[b].maxAvg << endl;
+    }
+    cout << totalCount << " students, " << bytes << " payload bytes";
+    if (totalCount > 0) {
+        cout << " (" << (double)bytes / totalCount << " bytes per student)";
+    }
+    cout << endl;
+    delete[] blocks;
+}
+
+// Ask for a page file name and cache budget, then open it
+bool openPagedRoster(PagedRoster& paged) {
+    string fileName;
+    long long budgetMb;
+    cout << "Enter paged roster file name: " << flush;
+    cin >> fileName;
+    clearInput();
+    cout << "Enter page cache budget in MB: " << flush;
+    cin >> budgetMb;
+    if (cin.fail() || budgetMb <= 0) {
+        clearInput();
+        cout << "Error: Please enter a positive number!" << endl;
+        return false;
+    }
+    if (!paged.open(fileName, budgetMb * 1024 * 1024)) {
+        cout << "Error: Cannot open paged roster file!" << endl;
+        return false;
+    }
+    return true;
+}
+
+// Show page cache counters after a scan
+void showCacheSummary(const PagedRoster& paged) {
+    cout << "Page cache: " << paged.getFrameCount() << " pages ("
+         << paged.getCacheBytes() / 1024 << " KB), hits " << paged.getHits()
+         << ", misses " << paged.getMisses() << ", pages read " << paged.getPagesRead() << endl;
+}
+
+// Write current roster to a paged roster file
+void exportPagedRoster() {
+    string fileName;
+    cout << "Enter paged roster file name: " << flush;
+    cin >> fileName;
+    clearInput();
+    PagedRoster paged;
+    RosterView students(roster);
+    if (paged.create(fileName, students.data(), students.size(), 1024 * 1024)) {
+        cout << "Paged roster saved: " << paged.size() << " students." << endl;
+    } else {
+        cout << "Error: Cannot write paged roster file!" << endl;
+    }
+}
+
+// Display all students of a paged roster (sequential scan with read-ahead)
+void showPagedStudents() {
+    PagedRoster paged;
+    if (!openPagedRoster(paged)) {
+        return;
+    }
+    paged.setSequential(true);
+    Student s;
+    for (long long i = 0; i < paged.size(); i++) {
+        if (!paged.getStudent(i, s)) {
+            cout << "Error: Cannot read page file!" << endl;
+            break;
+        }
+        cout << "\n--- Student " << (i + 1) << " ---" << endl;
+        s.display();
+    }
+    showCacheSummary(paged);
+}
+
+// Course statistics of a paged roster (sequential scan with read-ahead)
+void showPagedCourseStats() {
+    PagedRoster paged;
+    if (!openPagedRoster(paged)) {
+        return;
+    }
+    paged.setSequential(true);
+
+    double sum[5] = {0, 0, 0, 0, 0};
+    double maxScore[5] = {-1, -1, -1, -1, -1};
+    double minScore[5] = {101, 101, 101, 101, 101};
+    long long count[5] = {0, 0, 0, 0, 0};
+    long long failedStudents = 0;
+    Student s;
+    for (long long i = 0; i < paged.size(); i++) {
+        if (!paged.getStudent(i, s)) {
+            cout << "Error: Cannot read page file!" << endl;
+            return;
+        }
+        for (int c = 0; c < s.getCourseCount() && c < 5; c++) {
+            double score = s.getScore(c);
+            sum[c] += score;
+            count[c]++;
+            if (score > maxScore[c]) maxScore[c] = score;
+            if (score < minScore[c]) minScore[c] = score;
+        }
+        if (s.hasFailedCourse()) {
+            failedStudents++;
+        }
+    }
+
+    for (int c = 0; c < 5; c++) {
+        if (count[c] > 0) {
+            cout << "\nCourse " << (c + 1) << ":" << endl;
+            cout << "  Average Score : " << (sum[c] / count[c]) << endl;
+            cout << "  Highest Score : " << maxScore[c] << endl;
+            cout << "  Lowest Score  : " << minScore[c] << endl;
+            cout << "  Student Count : " << count[c] << endl;
+        }
+    }
+    cout << "\nStudents with failed courses: " << failedStudents << endl;
+    showCacheSummary(paged);
+}
+
+// Show changes published since the last call
+void showRecentChanges() {
+    char answer;
+    cout << "Combine repeated changes of the same field? (Y/N): " << flush;
+    cin >> answer;
+    clearInput();
+    bool coalesce = (answer == 'Y' || answer == 'y');
+
+    ChangeEvent events[64];
+    int total = 0;
+    int count;
+    while ((count = changeLog.poll(events, 64, coalesce)) > 0) {
+        for (int i = 0; i < count; i++) {
+            const ChangeEvent& e = events[i];
+            cout << "#" << e.sequence << "\t";
+            switch (e.type) {
+                case CHANGE_ADD:
+                    cout << "Added   " << unpackStudentId(e.studentId) << " " << e.newName;
+                    break;
+                case CHANGE_REMOVE:
+                    cout << "Removed " << unpackStudentId(e.studentId) << " " << e.newName;
+                    break;
+                case CHANGE_ID:
+                    cout << "ID      " << unpackStudentId(e.oldId) << " -> " << unpackStudentId(e.studentId);
+                    break;
+                case CHANGE_NAME:
+                    cout << "Name    " << unpackStudentId(e.studentId) << " " << e.oldName << " -> " << e.newName;
+                    break;
+                case CHANGE_SCORE:
+                    cout << "Score   " << unpackStudentId(e.studentId) << " Course" << (e.course + 1)
+                         << " " << e.oldScore << " -> " << e.newScore;
+                    break;
+            }
+            cout << endl;
+        }
+        total += count;
+    }
+    cout << total << " changes shown";
+    if (changeLog.getLost() > 0) {
+        cout << " (" << changeLog.getLost() << " older changes were overwritten)";
+    }
+    cout << endl;
+}
+
+// Course statistics from an enrollment file (lines of: student ID, course ID, score)
+void showEnrollmentFileStats() {
+    string fileName;
+    cout << "Enter enrollment file name: " << flush;
+    cin >> fileName;
+    clearInput();
+    CourseCatalog catalog;
+    addDefaultCourses(catalog);
+    EnrollmentMatrix matrix;
+    long long badRows = 0;
+    if (!loadEnrollmentFile(fileName, catalog, matrix, badRows)) {
+        cout << "Error: Cannot open enrollment file!" << endl;
+        return;
+    }
+
+    for (int c = 0; c < catalog.getCount(); c++) {
+        double sum;
+        double maxScore;
+        double minScore;
+        int count = matrix.courseStats(c, sum, maxScore, minScore);
+        if (count > 0) {
+            cout << "\nCourse " << catalog.getName(c) << " (ID " << catalog.getCourseId(c) << "):" << endl;
+            cout << "  Average Score : " << (sum / count) << endl;
+            cout << "  Highest Score : " << maxScore << endl;
+            cout << "  Lowest Score  : " << minScore << endl;
+            cout << "  Student Count : " << count << endl;
+        }
+    }
+    cout << "\n" << matrix.getRowCount() << " students, " << matrix.getEntryCount()
+         << " enrollments, " << matrix.memoryBytes() << " bytes";
+    if (badRows > 0) {
+        cout << ", " << badRows << " invalid rows skipped";
+    }
+    cout << endl;
+}
+
+// Encode students as CSV text on a background writer file
+bool writeRosterCsv(AsyncWriter& writer, int handle, const Student* const* list, int count) {
+    bool ok = writer.write(handle, "StudentID,Name,Age,Gender,CourseCount,Average,Scores\n");
+    for (int i = 0; i < count && ok; i++) {
+        const Student& s = *list[i];
+        ostringstream line;
+        line << s.getStudentId() << "," << s.getName() << "," << s.getAge() << ","
+             << s.getGender() << "," << s.getCourseCount() << "," << s.getAvgScore();
+        for (int c = 0; c < s.getCourseCount(); c++) {
+            line << "," << s.getScore(c);
+        }
+        line << "\n";
+        ok = writer.write(handle, line.str());
+    }
+    return ok;
+}
+
+// Export roster as CSV text (written in the background)
+void exportRosterCsv() {
+    string fileName;
+    cout << "Enter CSV file name: " << flush;
+    cin >> fileName;
+    clearInput();
+    if (startDump(fileName, writeRosterCsv)) {
+        cout << roster.size() << " students are being exported in the background." << endl;
+    }
+}
+
+// Show background writer counters
+void showWriteStatus() {
+    cout << "\n--- Background Write Status ---" << endl;
+    cout << "Worker threads : " << ioWriter.getWorkerCount() << endl;
+    cout << "Bytes written  : " << ioWriter.getBytesWritten() << endl;
+    cout << "Requests done  : " << ioWriter.getRequests() << endl;
+    cout << "Batches        : " << ioWriter.getBatches() << endl;
+    cout << "Errors         : " << ioWriter.getErrors() << endl;
+}
+
+// Save a roster snapshot for fast start (written in the background)
+void saveSnapshot() {
+    string fileName;
+    cout << "Enter snapshot file name: " << flush;
+    cin >> fileName;
+    clearInput();
+    if (startDump(fileName, writeSnapshot)) {
+        cout << "Snapshot of " << roster.size() << " students is being written in the background." << endl;
+        cout << "Start with: student_system --snapshot " << fileName << endl;
+    }
+}
+
+// Check the audit log hash chain and Merkle roots
+void verifyAuditTrail() {
+    if (!auditLog.isOpen()) {
+        cout << "Audit log is not open." << endl;
+        return;
+    }
+    int mode;
+    cout << "1. Incremental (new blocks only)  2. Full (tamper check): " << flush;
+    cin >> mode;
+    if (cin.fail() || (mode != 1 && mode != 2)) {
+        clearInput();
+        cout << "Invalid choice!" << endl;
+        return;
+    }
+    clearInput();
+    auditLog.flush();
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    AuditVerifyResult result;
+    bool ok = verifyAuditLog(auditLog.getFileName(), mode == 1,
+                             (int)thread::hardware_concurrency(), result);
+    long long ms = chrono::duration_cast<chrono::milliseconds>(
+        chrono::steady_clock::now() - start).count();
+
+    cout << "\nBlocks         : " << result.blocks << endl;
+    cout << "Entries        : " << result.entries << endl;
+    cout << "Blocks rehashed: " << result.blocksRehashed << " (" << ms << " ms)" << endl;
+    if (ok && mode == 1) {
+        cout << "New blocks are intact. Older blocks were trusted from the checkpoint;" << endl;
+        cout << "run a full check to detect tampering." << endl;
+    } else if (ok) {
+        cout << "Audit log is intact." << endl;
+    } else {
+        cout << "Audit log check FAILED at block " << result.firstBadBlock
+             << ": " << result.problem << endl;
+    }
+}
+
+// Show the latest grade changes from the audit log
+void showAuditTrail() {
+    if (!auditLog.isOpen()) {
+        cout << "Audit log is not open." << endl;
+        return;
+    }
+    auditLog.flush();
+    const int MAX_SHOWN = 20;
+    AuditEntry entries[MAX_SHOWN];
+    int count = readRecentAuditEntries(auditLog.getFileName(), entries, MAX_SHOWN);
+    cout << "\n--- Latest Grade Changes (" << auditLog.getEntriesWritten() << " in total) ---" << endl;
+    for (int i = 0; i < count; i++) {
+        const AuditEntry& e = entries[i];
+        int nameLength = 0;
+        while (nameLength < AUDIT_OPERATOR_CHARS && e.operatorName[nameLength] != '\0') {
+            nameLength++;
+        }
+        cout << "#" << e.sequence << " " << formatAuditTime(e.timeMicros)
+             << " " << string(e.operatorName, nameLength)
+             << ": " << unpackStudentId(e.studentId) << " course " << (e.course + 1)
+             << " " << e.oldScore << " -> " << e.newScore << endl;
+    }
+    if (count == 0) {
+        cout << "No grade changes recorded." << endl;
+    }
+}
+
+// Recompute every average in bulk, then optional averages of a course range
+void bulkAverages() {
+    // One column copy serves the recompute and the range averages
+    ScoreColumns columns;
+    waitForDump();
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    roster.recomputeAverages(columns);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << "Recomputed the averages of " << roster.size() << " students in " << ms << " ms." << endl;
+
+    int first, last;
+    cout << "Enter a course range for range averages (e.g. 1 3, or 0 0 to skip): " << flush;
+    cin >> first >> last;
+    if (cin.fail()) {
+        clearInput();
+        cout << "Error: Please enter valid numbers!" << endl;
+        return;
+    }
+    clearInput();
+    if (first == 0 && last == 0) {
+        return;
+    }
+    if (first < 1 || last < first || last > 5) {
+        cout << "Error: Courses must satisfy 1 <= first <= last <= 5!" << endl;
+        return;
+    }
+
+    // Same live-slot order as the columns
+    RosterView list(roster);
+    int count = list.size();
+    double* averages = new double[count > 0 ? count : 1];
+    columns.rangeAverages(first - 1, last - 1, averages);
+
+    const int MAX_SHOWN = 20;
+    int shown = 0;
+    int matched = 0;
+    double total = 0;
+    cout << "\nID\t\tName\tCourses " << first << "-" << last << " Average" << endl;
+    for (int i = 0; i < count; i++) {
+        if (averages[i] < 0) {
+            continue;
+        }
+        matched++;
+        total += averages[i];
+        if (shown < MAX_SHOWN) {
+            cout << list.at(i).getStudentId() << "\t" << list.at(i).getName() << "\t" << averages[i] << endl;
+            shown++;
+        }
+    }
+    delete[] averages;
+    if (matched == 0) {
+        cout << "No student takes courses " << first << " to " << last << "." << endl;
+        return;
+    }
+    if (matched > shown) {
+        cout << "... " << (matched - shown) << " more" << endl;
+    }
+    cout << "Mean over " << matched << " students: " << (total / matched) << endl;
+}
+
+// Show the bytes used by each part of the roster and what compact storage
+// would cost and change (or what it costs while it is in use)
+void showMemoryReport() {
+    if (compactMode) {
+        int count = compactRoster.size();
+        cout << "\n--- Compact Storage (" << count << " students) ---" << endl;
+        cout << "Per student     : " << sizeof(CompactStudent) << " bytes + " << sizeof(int)
+             << " bytes ID index (no heap allocations)" << endl;
+        cout << "Total           : " << compactRoster.memoryBytes() << " bytes" << endl;
+        return;
+    }
+    
+    RosterMemory usage;
+    roster.memoryUsage(usage);
+    int count = roster.size();
+    cout << "\n--- Roster Memory (" << count << " students, " << roster.getCapacity() << " slots) ---" << endl;
+    cout << "Student objects : " << usage.studentObjects << " bytes (" << sizeof(Student) << " per slot)" << endl;
+    cout << "ID/name strings : " << usage.stringHeap << " bytes" << endl;
+    cout << "Score arrays    : " << usage.scoreArrays << " bytes" << endl;
+    cout << "Slot tables     : " << usage.slotTables << " bytes" << endl;
+    cout << "Handle tables   : " << usage.handleTables << " bytes" << endl;
+    cout << "ID index        : " << usage.idIndex << " bytes" << endl;
+    cout << "Total           : " << usage.total << " bytes";
+    if (count > 0) {
+        cout << " (" << (usage.total / count) << " per student)";
+    }
+    cout << endl;
+
+    // Build a compact copy and compare what the menu would display
+    RosterView list(roster);
+    CompactRoster compact;
+    compact.build(list.data(), count);
+    int differences = compact.displayDifferences(list.data());
+    cout << "\n--- Compact Storage (data tools 19) ---" << endl;
+    cout << "Per student     : " << sizeof(CompactStudent) << " bytes + " << sizeof(int)
+         << " bytes ID index (no heap allocations)" << endl;
+    cout << "Total           : " << compact.memoryBytes() << " bytes" << endl;
+    cout << "Rounded         : " << compact.getRoundedStudents() << " students have scores finer than 0.01" << endl;
+    cout << "Display changes : " << differences << " students would be displayed differently" << endl;
+}
+
+// Move the students between the roster and compact storage. Switching to
+// compact storage is refused if any student would lose score precision or
+// be displayed differently.
+void switchStorageMode() {
+    if (compactMode) {
+        int count = compactRoster.size();
+        roster.reserve(count);
+        for (int i = 0; i < count; i++) {
+            Student s;
+            fromCompact(compactRoster.at(i), s);
+            roster.add(s);
+        }
+        compactRoster.clear();
+        compactMode = false;
+        cout << count << " students moved back to full storage." << endl;
+        return;
+    }
+    
+    // A running dump reads the Student objects that are about to go away
+    waitForDump();
+    RosterView list(roster);
+    int count = list.size();
+    compactRoster.build(list.data(), count);
+    long long rounded = compactRoster.getRoundedStudents();
+    int differences = compactRoster.displayDifferences(list.data());
+    if (rounded > 0 || differences > 0) {
+        cout << "Error: " << rounded << " students have scores finer than 0.01 and "
+             << differences << " would be displayed differently, storage not changed!" << endl;
+        compactRoster.clear();
+        return;
+    }
+    roster.clear();
+    compactMode = true;
+    cout << count << " students moved to compact storage ("
+         << compactRoster.memoryBytes() << " bytes)." << endl;
+    cout << "Modify, score, remove and roster export commands need full storage." << endl;
+}
+
+// Reconcile a score feed file from the testing center with the roster
+void reconcileScoreFeed() {
+    string fileName;
+    cout << "Enter score feed file name: " << flush;
+    cin >> fileName;
+    clearInput();
+
+    ScoreFeed feed;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    if (!feed.load(fileName)) {
+        cout << "Error: Cannot open score feed file!" << endl;
+        return;
+    }
+    chrono::steady_clock::time_point loaded = chrono::steady_clock::now();
+
+    ScoreJoinResult result;
+    joinScoreFeed(roster, feed, (int)thread::hardware_concurrency(), result);
+    chrono::steady_clock::time_point joined = chrono::steady_clock::now();
+
+    cout << "\nFeed rows      : " << feed.getCount() << endl;
+    cout << "Matched        : " << result.matches << endl;
+    cout << "Orphans        : " << result.orphans << " (unknown student ID)" << endl;
+    cout << "Conflicts      : " << result.conflicts << endl;
+    if (feed.getBadRows() > 0) {
+        cout << "Invalid lines  : " << feed.getBadRows() << " skipped" << endl;
+    }
+    cout << "Hash table on  : " << (result.builtOnFeed ? "feed" : "roster")
+         << ", " << result.threadsUsed << " probe thread(s)" << endl;
+    cout << "Load / join    : "
+         << chrono::duration_cast<chrono::milliseconds>(loaded - start).count() << " ms / "
+         << chrono::duration_cast<chrono::milliseconds>(joined - loaded).count() << " ms" << endl;
+
+    // List the first few problems
+    const int MAX_LISTED = 10;
+    int listed = 0;
+    for (long long i = 0; i < result.count && listed < MAX_LISTED; i++) {
+        const JoinRow& r = result.rows[i];
+        if (r.outcome == JOIN_ORPHAN) {
+            cout << "  Line " << (i + 1) << ": orphan " << unpackStudentId(feed.getId(i)) << endl;
+            listed++;
+        } else if (r.outcome == JOIN_CONFLICT) {
+            cout << "  Line " << (i + 1) << ": conflict " << unpackStudentId(feed.getId(i))
+                 << " course " << feed.getCourseId(i) << " score " << feed.getScore(i)
+                 << " - " << conflictReasonText(r.reason) << endl;
+            listed++;
+        }
+    }
+    if (result.orphans + result.conflicts > listed) {
+        cout << "  ... " << (result.orphans + result.conflicts - listed) << " more" << endl;
+    }
+
+    if (result.matches == 0) {
+        return;
+    }
+    char answer;
+    cout << "Apply " << result.matches << " matched scores? (Y/N): " << flush;
+    cin >> answer;
+    clearInput();
+    if (answer != 'Y' && answer != 'y') {
+        cout << "No scores changed." << endl;
+        return;
+    }
+    waitForDump();
+    long long changed = applyScoreMatches(roster, feed, result);
+    cout << changed << " scores updated (" << (result.matches - changed)
+         << " already up to date)." << endl;
+}
+
+// File and data tools menu
+void dataToolsMenu() {
+    cout << "\n--- File and Data Tools ---" << endl;
+    cout << "1. Save Roster to Archive" << endl;
+    cout << "2. Query Archive by Student ID" << endl;
+    cout << "3. Query Archive by Average Range" << endl;
+    cout << "4. Show Archive Block Index" << endl;
+    cout << "5. Export Roster to Paged File" << endl;
+    cout << "6. Display Paged Roster" << endl;
+    cout << "7. Paged Roster Course Statistics" << endl;
+    cout << "8. Show Recent Changes" << endl;
+    cout << "9. Course Statistics from Enrollment File" << endl;
+    cout << "10. Export Roster to CSV" << endl;
+    cout << "11. Background Write Status" << endl;
+    cout << "12. Reconcile Score Feed File" << endl;
+    cout << "13. Save Roster Snapshot (fast start)" << endl;
+    cout << "14. Startup Timing" << endl;
+    cout << "15. Verify Audit Log" << endl;
+    cout << "16. Show Audit Log" << endl;
+    cout << "17. Recompute All Averages (bulk)" << endl;
+    cout << "18. Memory Report" << endl;
+    cout << "19. Switch Roster Storage (compact/full)" << endl;
+    cout << "0. Back" << endl;
+    cout << "Please enter your choice: " << flush;
+
+    int choice;
+    cin >> choice;
+    if (cin.fail()) {
+        clearInput();
+        cout << "Error: Please enter a valid number!" << endl;
+        return;
+    }
+
+    switch (choice) {
+        case 1:
+            if (requireFullStorage()) {
+                saveArchive();
+            }
+            break;
+        case 2:
+            queryArchiveId();
+            break;
+        case 3:
+            queryArchiveAverage();
+            break;
+        case 4:
+            showArchiveIndex();
+            break;
+        case 5:
+            if (requireFullStorage()) {
+                exportPagedRoster();
+            }
+            break;
+        case 6:
+            showPagedStudents();
+            break;
+        case 7:
+            showPagedCourseStats();
+            break;
+        case 8:
+            showRecentChanges();
+            break;
+        case 9:
+            showEnrollmentFileStats();
+            break;
+        case 10:
+            if (requireFullStorage()) {
+                exportRosterCsv();
+            }
+            break;
+        case 11:
+            showWriteStatus();
+            break;
+        case 12:
+            if (requireFullStorage()) {
+                reconcileScoreFeed();
+            }
+            break;
+        case 13:
+            if (requireFullStorage()) {
+                saveSnapshot();
+            }
+            break;
+        case 14:
+            showStartupTiming();
+            break;
+        case 15:
+            verifyAuditTrail();
+            break;
+        case 16:
+            showAuditTrail();
+            break;
+        case 17:
+            if (requireFullStorage()) {
+                bulkAverages();
+            }
+            break;
+        case 18:
+            showMemoryReport();
+            break;
+        case 19:
+            switchStorageMode();
+            break;
+        case 0:
+            break;
+        default:
+            cout << "Invalid choice!" << endl;
+    }
+}
+
+// Remove a student from the roster
+void removeStudent() {
+    cout << "\n--- Remove Student ---" << endl;
+    
+    string searchId;
+    cout << "Enter student ID to remove: " << flush;
+    cin >> searchId;
+    clearInput();
+    
+    int slot = roster.findById(searchId);
+    if (slot < 0) {
+        cout << "No student found with ID: " << searchId << endl;
+        return;
+    }
+    
+    roster.at(slot).display();
+    // Held across the prompt: a handle follows the student if it is moved
+    StudentHandle handle = roster.handleOf(slot);
+    char answer;
+    cout << "Remove this student? (Y/N): " << flush;
+    cin >> answer;
+    clearInput();
+    if (answer != 'Y' && answer != 'y') {
+        cout << "Removal cancelled." << endl;
+        return;
+    }
+    
+    if (!roster.resolve(handle, slot)) {
+        cout << "Error: Student was already removed!" << endl;
+        return;
+    }
+    Student removedStudent = roster.at(slot);
+    roster.remove(handle);
+    publishStudentChange(CHANGE_REMOVE, removedStudent);
+    cout << "Student removed successfully! " << roster.size() << " students remain." << endl;
+}
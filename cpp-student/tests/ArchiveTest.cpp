@@ -0,0 +1,122 @@
+// ArchiveTest.cpp - Archive write/read round trips
+#include "TestHarness.h"
+#include "../Archive.h"
+#include <cstdio>
+
+// 300 students (three blocks), given out of ID order
+static const int ARCHIVE_STUDENTS = 300;
+
+static void makeArchiveRoster(Student* students, const Student** list) {
+    for (int i = 0; i < ARCHIVE_STUDENTS; i++) {
+        unsigned long long id = 2024000000ULL + (unsigned long long)((i * 37) % ARCHIVE_STUDENTS) * 3;
+        students[i] = makeTestStudent(id, i % 4 == 0 ? 5 : 3);
+        list[i] = &students[i];
+    }
+}
+
+TEST(archiveIndexCoversAllStudents) {
+    Student* students = new Student[ARCHIVE_STUDENTS];
+    const Student** list = new const Student*[ARCHIVE_STUDENTS];
+    makeArchiveRoster(students, list);
+    REQUIRE(writeArchive("test_roster.arc", list, ARCHIVE_STUDENTS));
+
+    ArchiveBlockInfo* blocks = nullptr;
+    int blockCount = 0;
+    int totalCount = 0;
+    REQUIRE(readArchiveIndex("test_roster.arc", blocks, blockCount, totalCount));
+    CHECK_EQUAL(ARCHIVE_STUDENTS, totalCount);
+    CHECK_EQUAL((ARCHIVE_STUDENTS + ARCHIVE_BLOCK_SIZE - 1) / ARCHIVE_BLOCK_SIZE, blockCount);
+    int sum = 0;
+    for (int b = 0; b < blockCount; b++) {
+        sum += blocks[b].count;
+        CHECK(blocks[b].minId <= blocks[b].maxId);
+        if (b > 0) {
+            // Stored sorted by ID
+            CHECK(blocks[b - 1].maxId < blocks[b].minId);
+        }
+    }
+    CHECK_EQUAL(ARCHIVE_STUDENTS, sum);
+    delete[] blocks;
+    delete[] list;
+    delete[] students;
+    remove("test_roster.arc");
+}
+
+TEST(archiveFindReturnsEveryStudent) {
+    Student* students = new Student[ARCHIVE_STUDENTS];
+    const Student** list = new const Student*[ARCHIVE_STUDENTS];
+    makeArchiveRoster(students, list);
+    REQUIRE(writeArchive("test_find.arc", list, ARCHIVE_STUDENTS));
+
+    for (int i = 0; i < ARCHIVE_STUDENTS; i++) {
+        Student found;
+        int blocksRead = 0;
+        CHECK(findInArchive("test_find.arc", students[i].getStudentId(), found, blocksRead));
+        CHECK(sameStudent(students[i], found));
+        CHECK_EQUAL(1, blocksRead);
+    }
+    // Between two stored IDs, and past the last one
+    Student missing;
+    int blocksRead = 0;
+    CHECK(!findInArchive("test_find.arc", "2024000001", missing, blocksRead));
+    CHECK(!findInArchive("test_find.arc", "2099000000", missing, blocksRead));
+    delete[] list;
+    delete[] students;
+    remove("test_find.arc");
+}
+
+TEST(archiveAverageQueryMatchesScan) {
+    Student* students = new Student[ARCHIVE_STUDENTS];
+    const Student** list = new const Student*[ARCHIVE_STUDENTS];
+    makeArchiveRoster(students, list);
+    REQUIRE(writeArchive("test_avg.arc", list, ARCHIVE_STUDENTS));
+
+    double low = 40;
+    double high = 60;
+    int expected = 0;
+    for (int i = 0; i < ARCHIVE_STUDENTS; i++) {
+        if (students[i].getAvgScore() >= low && students[i].getAvgScore() <= high) {
+            expected++;
+        }
+    }
+    Student* results = nullptr;
+    int blocksRead = 0;
+    int found = queryArchiveByAverage("test_avg.arc", low, high, results, blocksRead);
+    CHECK_EQUAL(expected, found);
+    for (int i = 0; i < found; i++) {
+        CHECK(results[i].getAvgScore() >= low && results[i].getAvgScore() <= high);
+    }
+    delete[] results;
+    delete[] list;
+    delete[] students;
+    remove("test_avg.arc");
+}
+
+TEST(archiveTruncatedFileIsRejected) {
+    Student* students = new Student[ARCHIVE_STUDENTS];
+    const Student** list = new const Student*[ARCHIVE_STUDENTS];
+    makeArchiveRoster(students, list);
+    REQUIRE(writeArchive("test_cut.arc", list, ARCHIVE_STUDENTS));
+
+    // Keep only the first 100 bytes
+    FILE* file = fopen("test_cut.arc", "rb");
+    REQUIRE(file != nullptr);
+    char head[100];
+    size_t kept = fread(head, 1, sizeof(head), file);
+    fclose(file);
+    file = fopen("test_cut.arc", "wb");
+    REQUIRE(file != nullptr);
+    fwrite(head, 1, kept, file);
+    fclose(file);
+
+    ArchiveBlockInfo* blocks = nullptr;
+    int blockCount = 0;
+    int totalCount = 0;
+    CHECK(!readArchiveIndex("test_cut.arc", blocks, blockCount, totalCount));
+    Student found;
+    int blocksRead = 0;
+    CHECK(!findInArchive("test_cut.arc", students[0].getStudentId(), found, blocksRead));
+    delete[] list;
+    delete[] students;
+    remove("test_cut.arc");
+}
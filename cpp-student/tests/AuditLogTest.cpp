@@ -0,0 +1,79 @@
+// AuditLogTest.cpp - Audit log round trip and tamper detection
+#include "TestHarness.h"
+#include "../AuditLog.h"
+#include <cstdio>
+#include <cstring>
+
+static const int AUDIT_TEST_ENTRIES = 2 * AUDIT_BATCH_SIZE + 88;
+
+// Write a log with AUDIT_TEST_ENTRIES grade changes, false on failure
+static bool writeTestLog(const string& fileName) {
+    remove(fileName.c_str());
+    remove((fileName + ".verified").c_str());
+    AsyncWriter writer(1);
+    AuditLog log;
+    if (!log.open(writer, fileName, "tester")) {
+        return false;
+    }
+    for (int i = 0; i < AUDIT_TEST_ENTRIES; i++) {
+        log.record(2024000000ULL + i, i % 5, (double)(i % 100), (double)((i + 1) % 100));
+    }
+    log.close();
+    writer.drain();
+    return writer.getErrors() == 0;
+}
+
+static void removeTestLog(const string& fileName) {
+    remove(fileName.c_str());
+    remove((fileName + ".verified").c_str());
+}
+
+TEST(auditLogRoundTrip) {
+    REQUIRE(writeTestLog("test_grades.audit"));
+    AuditVerifyResult result;
+    CHECK(verifyAuditLog("test_grades.audit", false, 4, result));
+    CHECK_EQUAL(-1LL, result.firstBadBlock);
+    CHECK_EQUAL((long long)AUDIT_TEST_ENTRIES, result.entries);
+    CHECK_EQUAL(3LL, result.blocks);
+
+    AuditEntry entries[10];
+    int n = readRecentAuditEntries("test_grades.audit", entries, 10);
+    REQUIRE(n == 10);
+    for (int k = 0; k < n; k++) {
+        int i = AUDIT_TEST_ENTRIES - 10 + k;
+        CHECK_EQUAL((unsigned long long)i, entries[k].sequence);
+        CHECK_EQUAL(2024000000ULL + i, entries[k].studentId);
+        CHECK_EQUAL(i % 5, (int)entries[k].course);
+        CHECK_EQUAL((double)(i % 100), entries[k].oldScore);
+        CHECK_EQUAL(string("tester"), string(entries[k].operatorName));
+    }
+    removeTestLog("test_grades.audit");
+}
+
+TEST(auditLogDetectsChangedEntry) {
+    REQUIRE(writeTestLog("test_tamper.audit"));
+    FILE* file = fopen("test_tamper.audit", "rb");
+    REQUIRE(file != nullptr);
+    string data;
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.append(buffer, n);
+    }
+    fclose(file);
+
+    // Change the old score of the entry for student 2024000300 (block 1)
+    unsigned long long id = 2024000300ULL;
+    size_t pos = data.find(string((const char*)&id, sizeof(id)));
+    REQUIRE(pos != string::npos);
+    data[pos + sizeof(id)] ^= 1;
+    file = fopen("test_tamper.audit", "wb");
+    REQUIRE(file != nullptr);
+    fwrite(data.data(), 1, data.length(), file);
+    fclose(file);
+
+    AuditVerifyResult result;
+    CHECK(!verifyAuditLog("test_tamper.audit", false, 4, result));
+    CHECK_EQUAL(1LL, result.firstBadBlock);
+    removeTestLog("test_tamper.audit");
+}
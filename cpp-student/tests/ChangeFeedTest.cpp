@@ -0,0 +1,176 @@
+// ChangeFeedTest.cpp - Change feed ordering, coalescing and concurrent readers
+#include "TestHarness.h"
+#include "../ChangeFeed.h"
+#include <thread>
+#include <cstring>
+
+// Score change event whose fields are all derived from one number, so a
+// torn copy of a slot is detected
+static void fillStressEvent(ChangeEvent& e, unsigned long long n) {
+    memset(&e, 0, sizeof(e));
+    e.type = CHANGE_SCORE;
+    e.course = (int)(n % 5);
+    e.studentId = 2024000000ULL + n;
+    e.oldId = n * 3;
+    e.oldScore = (double)n;
+    e.newScore = (double)n + 0.5;
+}
+
+static bool isWholeStressEvent(const ChangeEvent& e) {
+    unsigned long long n = e.studentId - 2024000000ULL;
+    return e.type == CHANGE_SCORE && e.course == (int)(n % 5) && e.oldId == n * 3
+        && e.oldScore == (double)n && e.newScore == (double)n + 0.5;
+}
+
+// Reader thread of the stress test
+struct StressReader {
+    ChangeSubscriber* subscriber;
+    atomic<bool>* producerDone;
+    unsigned long long received;
+    unsigned long long torn;
+    unsigned long long outOfOrder;
+};
+
+static void runStressReader(StressReader* reader) {
+    ChangeEvent events[64];
+    unsigned long long lastSequence = 0;
+    bool first = true;
+    while (true) {
+        bool done = reader->producerDone->load(memory_order_acquire);
+        int n = reader->subscriber->poll(events, 64, false);
+        for (int i = 0; i < n; i++) {
+            if (!isWholeStressEvent(events[i]) || events[i].sequence != events[i].studentId - 2024000000ULL) {
+                reader->torn++;
+            }
+            if (!first && events[i].sequence <= lastSequence) {
+                reader->outOfOrder++;
+            }
+            lastSequence = events[i].sequence;
+            first = false;
+        }
+        reader->received += n;
+        if (done && n == 0 && reader->subscriber->pending() == 0) {
+            break;
+        }
+    }
+}
+
+TEST(changeFeedConcurrentReadersSeeWholeEvents) {
+    // A small ring so the producer laps slow readers and overwrites slots
+    // while they are being copied
+    ChangeFeed feed(64, OVERWRITE_OLDEST);
+    const int READERS = 3;
+    const unsigned long long EVENTS = 400000;
+    ChangeSubscriber* subscribers[READERS];
+    StressReader readers[READERS];
+    atomic<bool> producerDone(false);
+    for (int r = 0; r < READERS; r++) {
+        subscribers[r] = new ChangeSubscriber(&feed);
+        REQUIRE(subscribers[r]->isRegistered());
+        readers[r].subscriber = subscribers[r];
+        readers[r].producerDone = &producerDone;
+        readers[r].received = 0;
+        readers[r].torn = 0;
+        readers[r].outOfOrder = 0;
+    }
+    thread threads[READERS];
+    for (int r = 0; r < READERS; r++) {
+        threads[r] = thread(runStressReader, &readers[r]);
+    }
+    for (unsigned long long n = 0; n < EVENTS; n++) {
+        ChangeEvent e;
+        fillStressEvent(e, n);
+        CHECK(feed.publish(e));
+    }
+    producerDone.store(true, memory_order_release);
+    for (int r = 0; r < READERS; r++) {
+        threads[r].join();
+        CHECK_EQUAL(0ULL, readers[r].torn);
+        CHECK_EQUAL(0ULL, readers[r].outOfOrder);
+        // Every event is either read or counted as lost, never both
+        CHECK_EQUAL(EVENTS, readers[r].received + subscribers[r]->getLost());
+        delete subscribers[r];
+    }
+    CHECK_EQUAL(EVENTS, feed.getHead());
+}
+
+TEST(changeFeedDropNewestKeepsOldEvents) {
+    ChangeFeed feed(8, DROP_NEWEST);
+    ChangeSubscriber subscriber(&feed);
+    for (unsigned long long n = 0; n < 12; n++) {
+        ChangeEvent e;
+        fillStressEvent(e, n);
+        CHECK_EQUAL(n < 8, feed.publish(e));
+    }
+    CHECK_EQUAL(4ULL, feed.getDropped());
+    ChangeEvent events[16];
+    int n = subscriber.poll(events, 16, false);
+    CHECK_EQUAL(8, n);
+    for (int i = 0; i < n; i++) {
+        CHECK(isWholeStressEvent(events[i]));
+        CHECK_EQUAL(2024000000ULL + i, events[i].studentId);
+    }
+    CHECK_EQUAL(0ULL, subscriber.getLost());
+}
+
+TEST(changeFeedCoalescesOnlyAdjacentChanges) {
+    ChangeFeed feed(64, OVERWRITE_OLDEST);
+    ChangeSubscriber subscriber(&feed);
+    setChangeFeed(&feed);
+    Student s = makeTestStudent(2024000010ULL, 3);
+    s.setScore(0, 10);
+    s.setScore(0, 20);
+    s.setScore(0, 30);
+    publishStudentChange(CHANGE_REMOVE, s);
+    publishStudentChange(CHANGE_ADD, s);
+    s.setScore(0, 40);
+    s.setScore(0, 50);
+    setChangeFeed(nullptr);
+
+    ChangeEvent events[16];
+    int n = subscriber.poll(events, 16, true);
+    REQUIRE(n == 4);
+    CHECK_EQUAL((int)CHANGE_SCORE, events[0].type);
+    CHECK_EQUAL(30.0, events[0].newScore);
+    CHECK_EQUAL((int)CHANGE_REMOVE, events[1].type);
+    CHECK_EQUAL((int)CHANGE_ADD, events[2].type);
+    // The later changes are not merged back across the remove and add
+    CHECK_EQUAL((int)CHANGE_SCORE, events[3].type);
+    CHECK_EQUAL(30.0, events[3].oldScore);
+    CHECK_EQUAL(50.0, events[3].newScore);
+}
+
+// Only "2024000099" is taken
+static bool testIdTaken(const string& id) {
+    return id == "2024000099";
+}
+
+TEST(modifyInfoRefusesTakenIdWithoutEvents) {
+    ChangeFeed feed(64, OVERWRITE_OLDEST);
+    ChangeSubscriber subscriber(&feed);
+    Student s = makeTestStudent(2024000010ULL, 3);
+    setChangeFeed(&feed);
+    {
+        ConsoleCapture console("1\n2024000099\n");
+        s.modifyInfo(testIdTaken);
+        CHECK(console.getOutput().find("already exists") != string::npos);
+    }
+    setChangeFeed(nullptr);
+    // No A -> B -> A pair: nothing changed, nothing published
+    CHECK_EQUAL(string("2024000010"), s.getStudentId());
+    CHECK_EQUAL(0ULL, feed.getHead());
+
+    setChangeFeed(&feed);
+    {
+        ConsoleCapture console("1\n2024000011\n");
+        s.modifyInfo(testIdTaken);
+    }
+    setChangeFeed(nullptr);
+    CHECK_EQUAL(string("2024000011"), s.getStudentId());
+    ChangeEvent events[4];
+    int n = subscriber.poll(events, 4, false);
+    REQUIRE(n == 1);
+    CHECK_EQUAL((int)CHANGE_ID, events[0].type);
+    CHECK_EQUAL(2024000010ULL, events[0].oldId);
+    CHECK_EQUAL(2024000011ULL, events[0].studentId);
+}
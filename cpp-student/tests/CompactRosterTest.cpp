@@ -0,0 +1,83 @@
+// CompactRosterTest.cpp - Compact records against the Student display path
+#include "TestHarness.h"
+#include "../CompactRoster.h"
+#include "../Workload.h"
+
+static const int COMPACT_STUDENTS = 2000;
+
+// Random students with scores in hundredths
+static void makeCompactRoster(Student* students, const Student** list, unsigned long long seed) {
+    SplitMix64 rng(seed);
+    for (int i = 0; i < COMPACT_STUDENTS; i++) {
+        int courseCount = rng.nextBelow(2) == 0 ? 3 : 5;
+        students[i] = makeTestStudent(2024000000ULL + rng.nextBelow(100000) * 10000 + i, courseCount);
+        for (int k = 0; k < courseCount; k++) {
+            students[i].setScore(k, (double)rng.nextBelow(10001) / 100);
+        }
+        students[i].calcAverage();
+        list[i] = &students[i];
+    }
+}
+
+TEST(compactStudentFitsInThirtyTwoBytes) {
+    CHECK(sizeof(CompactStudent) <= 28);
+    CompactRoster compact;
+    Student s = makeTestStudent(2024000001ULL, 3);
+    const Student* list[1] = { &s };
+    compact.build(list, 1);
+    CHECK_EQUAL(32LL, compact.memoryBytes());
+}
+
+TEST(compactDisplayMatchesStudentDisplay) {
+    Student* students = new Student[COMPACT_STUDENTS];
+    const Student** list = new const Student*[COMPACT_STUDENTS];
+    makeCompactRoster(students, list, 11);
+    CompactRoster compact;
+    compact.build(list, COMPACT_STUDENTS);
+    CHECK_EQUAL(0LL, compact.getRoundedStudents());
+    CHECK_EQUAL(0, compact.displayDifferences(list));
+
+    for (int i = 0; i < COMPACT_STUDENTS; i += 97) {
+        ostringstream full;
+        ostringstream small;
+        students[i].display(full);
+        students[i].displayBrief(full);
+        displayCompact(compact.at(i), small);
+        displayCompactBrief(compact.at(i), small);
+        CHECK_EQUAL(full.str(), small.str());
+        CHECK_EQUAL(students[i].hasFailedCourse(), compactHasFailedCourse(compact.at(i)));
+    }
+    delete[] list;
+    delete[] students;
+}
+
+TEST(compactFindByIdAndConvertBack) {
+    Student* students = new Student[COMPACT_STUDENTS];
+    const Student** list = new const Student*[COMPACT_STUDENTS];
+    makeCompactRoster(students, list, 12);
+    CompactRoster compact;
+    compact.build(list, COMPACT_STUDENTS);
+    for (int i = 0; i < COMPACT_STUDENTS; i++) {
+        int index = compact.findById(packStudentId(students[i].getStudentId()));
+        CHECK_EQUAL(i, index);
+        Student back;
+        fromCompact(compact.at(i), back);
+        CHECK(sameStudent(students[i], back));
+    }
+    CHECK_EQUAL(-1, compact.findById(1ULL));
+    CHECK_EQUAL(-1, compact.findById(9999999999ULL));
+    delete[] list;
+    delete[] students;
+}
+
+TEST(compactReportsRoundedScores) {
+    Student s = makeTestStudent(2024000002ULL, 3);
+    s.setScore(1, 85.255);
+    s.calcAverage();
+    Student t = makeTestStudent(2024000003ULL, 3);
+    const Student* list[2] = { &s, &t };
+    CompactRoster compact;
+    compact.build(list, 2);
+    CHECK_EQUAL(1LL, compact.getRoundedStudents());
+    CHECK_EQUAL(1, compact.displayDifferences(list));
+}
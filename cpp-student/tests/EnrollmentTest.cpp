@@ -0,0 +1,90 @@
+// EnrollmentTest.cpp - Course catalog, enrollment matrix and file ingest
+#include "TestHarness.h"
+#include "../Enrollment.h"
+#include <fstream>
+#include <cstdio>
+
+TEST(catalogFindsCoursesByHash) {
+    CourseCatalog catalog;
+    addDefaultCourses(catalog);
+    CHECK_EQUAL(8, catalog.getCount());
+    for (int k = 0; k < 5; k++) {
+        int column = catalog.findCourse(defaultCourseId(5, k));
+        REQUIRE(column >= 0);
+        CHECK_EQUAL(TYPE1_COURSE_BASE + 1 + k, catalog.getCourseId(column));
+    }
+    CHECK_EQUAL(-1, catalog.findCourse(999));
+    int added = catalog.addCourse(999, "Extra");
+    CHECK_EQUAL(added, catalog.findCourse(999));
+    CHECK_EQUAL(added, catalog.addCourse(999, "Again"));
+}
+
+TEST(matrixCourseStatsMatchRoster) {
+    const int n = 500;
+    Student* students = new Student[n];
+    const Student** list = new const Student*[n];
+    for (int i = 0; i < n; i++) {
+        students[i] = makeTestStudent(2024000000ULL + i, i % 3 == 0 ? 5 : 3);
+        list[i] = &students[i];
+    }
+    CourseCatalog catalog;
+    EnrollmentMatrix matrix;
+    matrix.buildFromRoster(list, n, catalog);
+    CHECK_EQUAL(n, matrix.getRowCount());
+
+    // Course 2 of the 3-course students, summed directly
+    int column = catalog.findCourse(defaultCourseId(3, 1));
+    REQUIRE(column >= 0);
+    double expectedSum = 0;
+    double expectedMax = -1;
+    double expectedMin = 101;
+    int expectedCount = 0;
+    for (int i = 0; i < n; i++) {
+        if (students[i].getCourseCount() == 3) {
+            double score = students[i].getScore(1);
+            expectedSum += score;
+            expectedMax = score > expectedMax ? score : expectedMax;
+            expectedMin = score < expectedMin ? score : expectedMin;
+            expectedCount++;
+        }
+    }
+    double sum, maxScore, minScore;
+    CHECK_EQUAL(expectedCount, matrix.courseStats(column, sum, maxScore, minScore));
+    CHECK_EQUAL(expectedSum, sum);
+    CHECK_EQUAL(expectedMax, maxScore);
+    CHECK_EQUAL(expectedMin, minScore);
+    delete[] list;
+    delete[] students;
+}
+
+TEST(enrollmentFileSkipsBadLines) {
+    ofstream out("test_enroll.txt");
+    out << "2024000001 101 90\n";
+    out << "2024000001 102 80.5\n";
+    out << "2024000002 101 70\n";
+    out << "20240x0003 101 70\n";          // bad ID
+    out << "2024000004 101 101\n";         // score out of range
+    out << "2024000005 101\n";             // missing score
+    out << "2024000006 301 55\n";          // new course
+    out << "2024000001 101 95\n";          // repeat, the last score wins
+    out.close();
+
+    CourseCatalog catalog;
+    addDefaultCourses(catalog);
+    EnrollmentMatrix matrix;
+    long long badRows = 0;
+    REQUIRE(loadEnrollmentFile("test_enroll.txt", catalog, matrix, badRows));
+    CHECK_EQUAL(3LL, badRows);
+    CHECK_EQUAL(3, matrix.getRowCount());
+    CHECK(catalog.findCourse(301) >= 0);
+
+    double sum, maxScore, minScore;
+    int column = catalog.findCourse(101);
+    CHECK_EQUAL(2, matrix.courseStats(column, sum, maxScore, minScore));
+    CHECK_EQUAL(165.0, sum);
+    CHECK_EQUAL(95.0, maxScore);
+
+    long long ignored;
+    CHECK(!loadEnrollmentFile("no_such_file.txt", catalog, matrix, ignored));
+    remove("test_enroll.txt");
+}
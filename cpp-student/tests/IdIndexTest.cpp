@@ -0,0 +1,116 @@
+// IdIndexTest.cpp - IdHash and IdIndex against std::map on random operations
+#include "TestHarness.h"
+#include "../IdHash.h"
+#include "../IdIndex.h"
+#include "../Workload.h"
+#include <map>
+
+// Random ID: mostly from two dense yearly blocks, some anywhere in 10 digits
+static unsigned long long randomId(SplitMix64& rng) {
+    unsigned long long kind = rng.nextBelow(10);
+    if (kind < 6) {
+        return 2024000000ULL + rng.nextBelow(40000);
+    }
+    if (kind < 9) {
+        return 2023000000ULL + rng.nextBelow(20000);
+    }
+    return rng.nextBelow(10000000000ULL);
+}
+
+// Apply the same random inserts, erases and finds to a table and a map
+template <class Table>
+static void compareWithMap(Table& table, unsigned long long seed, int operations) {
+    SplitMix64 rng(seed);
+    map<unsigned long long, int> expected;
+    for (int op = 0; op < operations; op++) {
+        unsigned long long id = randomId(rng);
+        unsigned long long kind = rng.nextBelow(10);
+        if (kind < 5) {
+            int value = (int)rng.nextBelow(1000000);
+            table.insert(id, value);
+            expected[id] = value;
+        } else if (kind < 8) {
+            bool erased = table.erase(id);
+            CHECK_EQUAL(expected.erase(id) == 1, erased);
+        } else {
+            int value = -1;
+            bool found = table.find(id, value);
+            map<unsigned long long, int>::iterator it = expected.find(id);
+            CHECK_EQUAL(it != expected.end(), found);
+            if (found && it != expected.end()) {
+                CHECK_EQUAL(it->second, value);
+            }
+        }
+    }
+    CHECK_EQUAL((long long)expected.size(), table.getSize());
+    for (map<unsigned long long, int>::iterator it = expected.begin(); it != expected.end(); ++it) {
+        int value = -1;
+        CHECK(table.find(it->first, value));
+        CHECK_EQUAL(it->second, value);
+    }
+}
+
+TEST(idHashMatchesMap) {
+    IdHash hash;
+    compareWithMap(hash, 1, 200000);
+}
+
+TEST(idHashClearKeepsWorking) {
+    IdHash hash;
+    compareWithMap(hash, 2, 50000);
+    hash.clear();
+    CHECK_EQUAL(0LL, hash.getSize());
+    int value;
+    CHECK(!hash.find(2024000001ULL, value));
+    compareWithMap(hash, 3, 50000);
+}
+
+TEST(idIndexMatchesMap) {
+    IdIndex index;
+    compareWithMap(index, 4, 300000);
+    // The yearly blocks are dense enough for range arrays
+    CHECK(index.getDenseRanges() > 0);
+}
+
+TEST(idIndexPromoteAndDemote) {
+    IdIndex index;
+    map<unsigned long long, int> expected;
+    // Fill one range past the promote threshold, then empty it below the
+    // demote threshold, checking every ID on the way
+    unsigned long long base = 2024000000ULL;
+    for (int i = 0; i < ID_RANGE_PROMOTE + 100; i++) {
+        index.insert(base + i, i);
+        expected[base + i] = i;
+    }
+    CHECK(index.getDenseRanges() > 0);
+    for (int i = 0; i < ID_RANGE_PROMOTE + 100 - ID_RANGE_DEMOTE / 2; i++) {
+        CHECK(index.erase(base + i));
+        expected.erase(base + i);
+    }
+    CHECK_EQUAL(0, index.getDenseRanges());
+    CHECK_EQUAL((long long)expected.size(), index.getSize());
+    for (int i = 0; i < ID_RANGE_PROMOTE + 100; i++) {
+        int value = -1;
+        bool found = index.find(base + i, value);
+        CHECK_EQUAL(expected.count(base + i) == 1, found);
+        if (found) {
+            CHECK_EQUAL(i, value);
+        }
+    }
+}
+
+TEST(idIndexOutliersAndClear) {
+    IdIndex index;
+    // IDs far apart (one per range) stay in the hash
+    for (int i = 0; i < 5000; i++) {
+        index.insert((unsigned long long)i * 1999993ULL, i);
+    }
+    for (int i = 0; i < 5000; i++) {
+        int value = -1;
+        CHECK(index.find((unsigned long long)i * 1999993ULL, value));
+        CHECK_EQUAL(i, value);
+    }
+    index.clear();
+    CHECK_EQUAL(0LL, index.getSize());
+    compareWithMap(index, 5, 100000);
+}
@@ -0,0 +1,152 @@
+// PagedRosterTest.cpp - Page file round trip through a small cache, records
+#include "TestHarness.h"
+#include "../PagedRoster.h"
+#include <cstdio>
+
+// 1000 students over 16 pages, cache of 4 pages: most accesses evict
+static const int PAGED_STUDENTS = 1000;
+static const long long SMALL_CACHE = 4LL * RECORDS_PER_PAGE * sizeof(StudentRecord);
+
+static void makePagedRoster(Student* students, const Student** list) {
+    for (int i = 0; i < PAGED_STUDENTS; i++) {
+        students[i] = makeTestStudent(2024100000ULL + i, i % 2 == 0 ? 3 : 5);
+        list[i] = &students[i];
+    }
+}
+
+TEST(pagedRosterRoundTrip) {
+    Student* students = new Student[PAGED_STUDENTS];
+    const Student** list = new const Student*[PAGED_STUDENTS];
+    makePagedRoster(students, list);
+
+    PagedRoster paged;
+    REQUIRE(paged.create("test_roster.page", list, PAGED_STUDENTS, SMALL_CACHE));
+    CHECK_EQUAL((long long)PAGED_STUDENTS, paged.size());
+    CHECK_EQUAL(4, paged.getFrameCount());
+    // Sequential, then strided (every access a different page)
+    for (int i = 0; i < PAGED_STUDENTS; i++) {
+        Student found;
+        CHECK(paged.getStudent(i, found));
+        CHECK(sameStudent(students[i], found));
+    }
+    for (int i = 0; i < PAGED_STUDENTS; i++) {
+        int index = (i * RECORDS_PER_PAGE + i / 16) % PAGED_STUDENTS;
+        Student found;
+        CHECK(paged.getStudent(index, found));
+        CHECK(sameStudent(students[index], found));
+    }
+    Student outside;
+    CHECK(!paged.getStudent(PAGED_STUDENTS, outside));
+    CHECK(!paged.getStudent(-1, outside));
+    paged.close();
+    delete[] list;
+    delete[] students;
+    remove("test_roster.page");
+}
+
+TEST(pagedRosterWritesSurviveEvictionAndReopen) {
+    Student* students = new Student[PAGED_STUDENTS];
+    const Student** list = new const Student*[PAGED_STUDENTS];
+    makePagedRoster(students, list);
+
+    PagedRoster paged;
+    REQUIRE(paged.create("test_write.page", list, PAGED_STUDENTS, SMALL_CACHE));
+    // Change one student per page, so dirty pages are evicted and written back
+    for (int i = 0; i < PAGED_STUDENTS; i += RECORDS_PER_PAGE) {
+        students[i] = makeTestStudent(2024900000ULL + i, 5);
+        CHECK(paged.putStudent(i, students[i]));
+    }
+    Student extra = makeTestStudent(2024999999ULL, 3);
+    CHECK(paged.appendStudent(extra));
+    CHECK(paged.flush());
+    CHECK(paged.getPagesWritten() > 0);
+    paged.close();
+
+    PagedRoster reopened;
+    REQUIRE(reopened.open("test_write.page", SMALL_CACHE));
+    CHECK_EQUAL((long long)PAGED_STUDENTS + 1, reopened.size());
+    for (int i = 0; i < PAGED_STUDENTS; i++) {
+        Student found;
+        CHECK(reopened.getStudent(i, found));
+        CHECK(sameStudent(students[i], found));
+    }
+    Student found;
+    CHECK(reopened.getStudent(PAGED_STUDENTS, found));
+    CHECK(sameStudent(extra, found));
+    reopened.close();
+    delete[] list;
+    delete[] students;
+    remove("test_write.page");
+}
+
+TEST(pagedRosterTruncatedFileIsRejected) {
+    Student* students = new Student[PAGED_STUDENTS];
+    const Student** list = new const Student*[PAGED_STUDENTS];
+    makePagedRoster(students, list);
+    PagedRoster paged;
+    REQUIRE(paged.create("test_cut.page", list, PAGED_STUDENTS, SMALL_CACHE));
+    paged.close();
+
+    // Drop the last record of the padded last page
+    FILE* file = fopen("test_cut.page", "rb");
+    REQUIRE(file != nullptr);
+    string data;
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.append(buffer, n);
+    }
+    fclose(file);
+    file = fopen("test_cut.page", "wb");
+    REQUIRE(file != nullptr);
+    fwrite(data.data(), 1, data.length() - sizeof(StudentRecord), file);
+    fclose(file);
+
+    PagedRoster reopened;
+    CHECK(!reopened.open("test_cut.page", SMALL_CACHE));
+    CHECK(!reopened.isOpen());
+    delete[] list;
+    delete[] students;
+    remove("test_cut.page");
+}
+
+TEST(recordValidationRejectsBadFields) {
+    Student s = makeTestStudent(2024000042ULL, 5);
+    StudentRecord good;
+    toRecord(s, good);
+    CHECK(isValidRecord(good));
+    Student back;
+    CHECK(fromRecord(good, back));
+    CHECK(sameStudent(s, back));
+
+    StudentRecord bad = good;
+    bad.studentId[3] = 'x';
+    CHECK(!isValidRecord(bad));
+    bad = good;
+    bad.name[0] = '\0';
+    CHECK(!isValidRecord(bad));
+    bad = good;
+    bad.age = 0;
+    CHECK(!isValidRecord(bad));
+    bad = good;
+    bad.age = 151;
+    CHECK(!isValidRecord(bad));
+    bad = good;
+    bad.gender = 'X';
+    CHECK(!isValidRecord(bad));
+    bad = good;
+    bad.courseCount = 4;
+    CHECK(!isValidRecord(bad));
+    bad = good;
+    bad.scores[4] = 100.5;
+    CHECK(!isValidRecord(bad));
+    bad = good;
+    bad.scores[0] = -1;
+    CHECK(!isValidRecord(bad));
+
+    // A rejected record leaves the student unchanged
+    Student kept = makeTestStudent(2024000043ULL, 3);
+    Student before = kept;
+    CHECK(!fromRecord(bad, kept));
+    CHECK(sameStudent(before, kept));
+}
@@ -0,0 +1,111 @@
+// RosterTest.cpp - Roster removal, handles and incremental compaction
+#include "TestHarness.h"
+#include "../Roster.h"
+
+static const unsigned long long ROSTER_BASE_ID = 2024000000ULL;
+
+// Roster with n students, IDs ROSTER_BASE_ID + i
+static void fillRoster(Roster& roster, StudentHandle* handles, int n) {
+    roster.reserve(n);
+    for (int i = 0; i < n; i++) {
+        handles[i] = roster.add(makeTestStudent(ROSTER_BASE_ID + i, i % 3 == 0 ? 5 : 3));
+    }
+}
+
+TEST(rosterRemovedHandlesGoStale) {
+    Roster roster;
+    StudentHandle handles[10];
+    fillRoster(roster, handles, 10);
+    int slot = -1;
+    REQUIRE(roster.resolve(handles[4], slot));
+    CHECK(roster.remove(handles[4]));
+    CHECK(!roster.resolve(handles[4], slot));
+    CHECK(!roster.remove(handles[4]));
+    CHECK_EQUAL(9, roster.size());
+    CHECK_EQUAL(-1, roster.findById(unpackStudentId(ROSTER_BASE_ID + 4)));
+
+    // The freed handle entry is reused with a new generation: the old
+    // handle must not resolve to the new student
+    StudentHandle reused = roster.add(makeTestStudent(ROSTER_BASE_ID + 100, 3));
+    CHECK_EQUAL(handles[4].index, reused.index);
+    CHECK(reused.generation != handles[4].generation);
+    CHECK(!roster.resolve(handles[4], slot));
+    REQUIRE(roster.resolve(reused, slot));
+    CHECK_EQUAL(unpackStudentId(ROSTER_BASE_ID + 100), roster.at(slot).getStudentId());
+}
+
+TEST(rosterCompactionKeepsOrderHandlesAndIndex) {
+    const int n = 5000;
+    Roster roster;
+    StudentHandle* handles = new StudentHandle[n];
+    fillRoster(roster, handles, n);
+    // Remove every third student and a block at the front
+    for (int i = 0; i < n; i++) {
+        if (i % 3 == 1 || i < 200) {
+            CHECK(roster.remove(handles[i]));
+        }
+    }
+    int live = roster.size();
+    REQUIRE(roster.isCompacting());
+
+    // Small steps, checking the live students between steps
+    int steps = 0;
+    while (roster.isCompacting() && steps < 100000) {
+        roster.compactStep(1);
+        steps++;
+        if (steps % 50 == 0) {
+            CHECK_EQUAL(live, roster.size());
+            // Student n - 2 is kept (n - 1 is removed, n - 1 = 1 mod 3)
+            int slot = -1;
+            REQUIRE(roster.resolve(handles[n - 2], slot));
+            CHECK_EQUAL(unpackStudentId(ROSTER_BASE_ID + n - 2), roster.at(slot).getStudentId());
+        }
+    }
+    REQUIRE(!roster.isCompacting());
+    CHECK_EQUAL(live, roster.getSlotCount());
+
+    // Original order, every handle and ID lookup lands on its student
+    int slot = 0;
+    for (int i = 0; i < n; i++) {
+        string id = unpackStudentId(ROSTER_BASE_ID + i);
+        int found = -1;
+        if (i % 3 == 1 || i < 200) {
+            CHECK(!roster.resolve(handles[i], found));
+            CHECK_EQUAL(-1, roster.findById(id));
+            continue;
+        }
+        CHECK(roster.isLive(slot));
+        CHECK_EQUAL(id, roster.at(slot).getStudentId());
+        CHECK(roster.resolve(handles[i], found));
+        CHECK_EQUAL(slot, found);
+        CHECK_EQUAL(slot, roster.findById(id));
+        slot++;
+    }
+    delete[] handles;
+}
+
+TEST(rosterViewListsLiveStudents) {
+    Roster roster;
+    StudentHandle handles[20];
+    fillRoster(roster, handles, 20);
+    roster.remove(handles[0]);
+    roster.remove(handles[7]);
+    RosterView view(roster);
+    CHECK_EQUAL(18, view.size());
+    for (int i = 0; i < view.size(); i++) {
+        CHECK(view.at(i).getStudentId() != unpackStudentId(ROSTER_BASE_ID + 0));
+        CHECK(view.at(i).getStudentId() != unpackStudentId(ROSTER_BASE_ID + 7));
+    }
+}
+
+TEST(rosterVersionChangesOnEdits) {
+    Roster roster;
+    StudentHandle handles[3];
+    fillRoster(roster, handles, 3);
+    unsigned long long version = roster.getVersion();
+    roster.at(0).setScore(0, roster.at(0).getScore(0) == 50 ? 51 : 50);
+    CHECK(roster.getVersion() != version);
+    version = roster.getVersion();
+    roster.remove(handles[1]);
+    CHECK(roster.getVersion() != version);
+}
@@ -0,0 +1,76 @@
+// ScoreJoinTest.cpp - Score feed join outcomes on both hash table sides
+#include "TestHarness.h"
+#include "../ScoreJoin.h"
+#include "../Roster.h"
+#include "../Enrollment.h"
+
+// Roster of n students: even IDs take 5 courses, odd IDs 3
+static void fillJoinRoster(Roster& roster, int n) {
+    roster.reserve(n);
+    for (int i = 0; i < n; i++) {
+        roster.add(makeTestStudent(2024000000ULL + i, i % 2 == 0 ? 5 : 3));
+    }
+}
+
+// Feed rows with every outcome, checked for a roster of n students
+static void checkJoin(int rosterSize, int extraMatches) {
+    Roster roster;
+    fillJoinRoster(roster, rosterSize);
+    ScoreFeed feed;
+    feed.addRow(2024000000ULL, TYPE1_COURSE_BASE + 2, 77);     // match, course index 1
+    feed.addRow(2024000001ULL, TYPE2_COURSE_BASE + 1, 66);     // match, course index 0
+    feed.addRow(2099000000ULL, TYPE1_COURSE_BASE + 1, 50);     // orphan
+    feed.addRow(2024000001ULL, TYPE1_COURSE_BASE + 1, 50);     // wrong student type
+    feed.addRow(2024000002ULL, TYPE1_COURSE_BASE + 1, 101);    // score out of range
+    feed.addRow(2024000004ULL, TYPE1_COURSE_BASE + 3, 40);     // repeated with
+    feed.addRow(2024000004ULL, TYPE1_COURSE_BASE + 3, 41);     // different scores
+    for (int i = 0; i < extraMatches; i++) {
+        feed.addRow(2024000006ULL + 2 * i, TYPE1_COURSE_BASE + 5, 99);
+    }
+
+    ScoreJoinResult result;
+    joinScoreFeed(roster, feed, 4, result);
+    REQUIRE(result.count == feed.getCount());
+    CHECK_EQUAL(2LL + extraMatches, result.matches);
+    CHECK_EQUAL(1LL, result.orphans);
+    CHECK_EQUAL(4LL, result.conflicts);
+    CHECK_EQUAL((int)JOIN_MATCH, (int)result.rows[0].outcome);
+    CHECK_EQUAL(1, (int)result.rows[0].course);
+    CHECK_EQUAL((int)JOIN_ORPHAN, (int)result.rows[2].outcome);
+    CHECK_EQUAL(-1, result.rows[2].slot);
+    CHECK_EQUAL((int)CONFLICT_COURSE, (int)result.rows[3].reason);
+    CHECK_EQUAL((int)CONFLICT_SCORE, (int)result.rows[4].reason);
+    CHECK_EQUAL((int)CONFLICT_DUPLICATE, (int)result.rows[5].reason);
+    CHECK_EQUAL((int)CONFLICT_DUPLICATE, (int)result.rows[6].reason);
+
+    long long changed = applyScoreMatches(roster, feed, result);
+    CHECK_EQUAL(2LL + extraMatches, changed);
+    int slot = roster.findById("2024000000");
+    REQUIRE(slot >= 0);
+    CHECK_EQUAL(77.0, roster.at(slot).getScore(1));
+    slot = roster.findById("2024000004");
+    REQUIRE(slot >= 0);
+    CHECK(roster.at(slot).getScore(2) != 40 && roster.at(slot).getScore(2) != 41);
+}
+
+TEST(scoreJoinHashOnFeed) {
+    // Feed smaller than the roster
+    checkJoin(5000, 0);
+}
+
+TEST(scoreJoinHashOnRoster) {
+    // Feed larger than the roster
+    checkJoin(400, 150);
+}
+
+TEST(scoreFeedRangeCheck) {
+    ScoreFeed feed;
+    feed.addRow(2024000000ULL, 101, 0);
+    feed.addRow(2024000000ULL, 102, 100);
+    feed.addRow(2024000000ULL, 103, -1);
+    feed.addRow(2024000000ULL, 104, 100.5);
+    CHECK(feed.isScoreValid(0));
+    CHECK(feed.isScoreValid(1));
+    CHECK(!feed.isScoreValid(2));
+    CHECK(!feed.isScoreValid(3));
+}
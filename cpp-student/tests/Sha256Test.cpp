@@ -0,0 +1,79 @@
+// Sha256Test.cpp - SHA-256 known-answer vectors (FIPS 180-4 examples)
+#include "TestHarness.h"
+#include "../Sha256.h"
+#include <cstring>
+
+// Digest as lowercase hex
+static string hexDigest(const unsigned char digest[SHA256_BYTES]) {
+    const char* digits = "0123456789abcdef";
+    string text;
+    for (int i = 0; i < SHA256_BYTES; i++) {
+        text += digits[digest[i] >> 4];
+        text += digits[digest[i] & 15];
+    }
+    return text;
+}
+
+static string sha256Hex(const string& message) {
+    unsigned char digest[SHA256_BYTES];
+    sha256(message.data(), message.length(), digest);
+    return hexDigest(digest);
+}
+
+TEST(sha256EmptyMessage) {
+    CHECK_EQUAL(string("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"),
+                sha256Hex(""));
+}
+
+TEST(sha256Abc) {
+    CHECK_EQUAL(string("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"),
+                sha256Hex("abc"));
+}
+
+TEST(sha256TwoBlockMessage) {
+    // 56 bytes: the length no longer fits in the first block
+    CHECK_EQUAL(string("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"),
+                sha256Hex("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"));
+}
+
+TEST(sha256MillionA) {
+    // One million 'a' fed in uneven pieces through update()
+    Sha256 hash;
+    char chunk[997];
+    memset(chunk, 'a', sizeof(chunk));
+    int left = 1000000;
+    while (left > 0) {
+        int n = left < (int)sizeof(chunk) ? left : (int)sizeof(chunk);
+        hash.update(chunk, n);
+        left -= n;
+    }
+    unsigned char digest[SHA256_BYTES];
+    hash.final(digest);
+    CHECK_EQUAL(string("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"),
+                hexDigest(digest));
+}
+
+TEST(sha256IncrementalMatchesOneShot) {
+    string message;
+    for (int i = 0; i < 300; i++) {
+        message += (char)(i * 31);
+    }
+    Sha256 hash;
+    // Piece sizes crossing the 64-byte block boundary in different places
+    size_t pos = 0;
+    size_t piece = 1;
+    while (pos < message.length()) {
+        size_t n = piece < message.length() - pos ? piece : message.length() - pos;
+        hash.update(message.data() + pos, n);
+        pos += n;
+        piece = piece * 3 % 71 + 1;
+    }
+    unsigned char digest[SHA256_BYTES];
+    hash.final(digest);
+    CHECK_EQUAL(sha256Hex(message), hexDigest(digest));
+
+    // final() resets the object for the next digest
+    hash.update("abc", 3);
+    hash.final(digest);
+    CHECK_EQUAL(sha256Hex("abc"), hexDigest(digest));
+}
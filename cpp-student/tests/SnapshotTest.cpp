@@ -0,0 +1,143 @@
+// SnapshotTest.cpp - Snapshot round trip, lookups and damaged files
+#include "TestHarness.h"
+#include "../Snapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+
+static const int SNAPSHOT_STUDENTS = 1000;
+
+// Students with IDs 2024000000 + 2i, given in reverse order
+static void makeSnapshotRoster(Student* students, const Student** list) {
+    for (int i = 0; i < SNAPSHOT_STUDENTS; i++) {
+        students[i] = makeTestStudent(2024000000ULL + 2 * (SNAPSHOT_STUDENTS - 1 - i), i % 5 == 0 ? 5 : 3);
+        list[i] = &students[i];
+    }
+}
+
+// Read a whole file, false if it cannot be opened
+static bool readFile(const string& fileName, string& data) {
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    data.clear();
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.append(buffer, n);
+    }
+    fclose(file);
+    return true;
+}
+
+static bool writeFile(const string& fileName, const string& data) {
+    FILE* file = fopen(fileName.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = fwrite(data.data(), 1, data.length(), file) == data.length();
+    fclose(file);
+    return ok;
+}
+
+TEST(snapshotFindAndLoadRoundTrip) {
+    Student* students = new Student[SNAPSHOT_STUDENTS];
+    const Student** list = new const Student*[SNAPSHOT_STUDENTS];
+    makeSnapshotRoster(students, list);
+    REQUIRE(writeSnapshot("test_roster.snap", list, SNAPSHOT_STUDENTS));
+
+    Snapshot snapshot;
+    REQUIRE(snapshot.open("test_roster.snap"));
+    CHECK_EQUAL((long long)SNAPSHOT_STUDENTS, snapshot.size());
+    for (int i = 0; i < SNAPSHOT_STUDENTS; i += 7) {
+        Student found;
+        CHECK(snapshot.find(students[i].getStudentId(), found));
+        CHECK(sameStudent(students[i], found));
+    }
+    Student missing;
+    CHECK(!snapshot.find("2024000001", missing));
+    CHECK(!snapshot.find("not an id", missing));
+
+    Roster roster;
+    snapshot.startLoad(roster);
+    CHECK(snapshot.waitLoaded());
+    CHECK_EQUAL(SNAPSHOT_STUDENTS, roster.size());
+    CHECK_EQUAL((long long)SNAPSHOT_STUDENTS, snapshot.getLoadedCount());
+    for (int i = 0; i < SNAPSHOT_STUDENTS; i++) {
+        int slot = roster.findById(students[i].getStudentId());
+        REQUIRE(slot >= 0);
+        CHECK(sameStudent(students[i], roster.at(slot)));
+    }
+    snapshot.close();
+    delete[] list;
+    delete[] students;
+    remove("test_roster.snap");
+}
+
+TEST(snapshotDamagedRecordIsRejected) {
+    Student* students = new Student[SNAPSHOT_STUDENTS];
+    const Student** list = new const Student*[SNAPSHOT_STUDENTS];
+    makeSnapshotRoster(students, list);
+    REQUIRE(writeSnapshot("test_bad.snap", list, SNAPSHOT_STUDENTS));
+
+    // Age 0 in the record of one student (the age byte follows the 10 ID
+    // digits and the 8 name bytes)
+    string target = students[SNAPSHOT_STUDENTS / 2].getStudentId();
+    string data;
+    REQUIRE(readFile("test_bad.snap", data));
+    size_t pos = data.find(target);
+    REQUIRE(pos != string::npos);
+    data[pos + offsetof(StudentRecord, age)] = 0;
+    REQUIRE(writeFile("test_bad.snap", data));
+
+    Snapshot snapshot;
+    REQUIRE(snapshot.open("test_bad.snap"));
+    Student found;
+    CHECK(!snapshot.find(target, found));
+    CHECK(snapshot.find(students[0].getStudentId(), found));
+
+    // The load stops at the bad record and reports the failure
+    Roster roster;
+    snapshot.startLoad(roster);
+    CHECK(!snapshot.waitLoaded());
+    CHECK(roster.size() < SNAPSHOT_STUDENTS);
+    CHECK_EQUAL(-1, roster.findById(target));
+    snapshot.close();
+    delete[] list;
+    delete[] students;
+    remove("test_bad.snap");
+}
+
+TEST(snapshotTruncatedFileIsRejected) {
+    Student* students = new Student[SNAPSHOT_STUDENTS];
+    const Student** list = new const Student*[SNAPSHOT_STUDENTS];
+    makeSnapshotRoster(students, list);
+    REQUIRE(writeSnapshot("test_cut.snap", list, SNAPSHOT_STUDENTS));
+    string data;
+    REQUIRE(readFile("test_cut.snap", data));
+
+    // One record short, and one byte extra
+    REQUIRE(writeFile("test_cut.snap", data.substr(0, data.length() - sizeof(StudentRecord))));
+    Snapshot shortFile;
+    CHECK(!shortFile.open("test_cut.snap"));
+    REQUIRE(writeFile("test_cut.snap", data + "x"));
+    Snapshot longFile;
+    CHECK(!longFile.open("test_cut.snap"));
+
+    // A record count that does not fit the file (8 bytes after the magic
+    // and the version)
+    string huge = data;
+    for (int i = 0; i < 8; i++) {
+        huge[8 + i] = (char)0x7f;
+    }
+    REQUIRE(writeFile("test_cut.snap", huge));
+    Snapshot hugeCount;
+    CHECK(!hugeCount.open("test_cut.snap"));
+
+    Snapshot missing;
+    CHECK(!missing.open("no_such_file.snap"));
+    delete[] list;
+    delete[] students;
+    remove("test_cut.snap");
+}
@@ -0,0 +1,74 @@
+// TestHarness.h - Minimal test registry and checks for the component tests
+#ifndef TESTHARNESS_H
+#define TESTHARNESS_H
+
+#include "../Student.h"
+#include <sstream>
+
+typedef void (*TestFunction)();
+
+// Add a test to the registry (used by TEST), returns true
+bool registerTest(const char* name, TestFunction function);
+
+// Record a failed check of the running test
+void reportFailure(const char* file, int line, const string& message);
+
+// Define and register a test function
+#define TEST(name) \
+    static void name(); \
+    static bool name##Registered = registerTest(#name, name); \
+    static void name()
+
+// Record a failure and go on with the test
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            reportFailure(__FILE__, __LINE__, "CHECK(" #condition ")"); \
+        } \
+    } while (0)
+
+// Record a failure showing both values
+#define CHECK_EQUAL(expected, actual) \
+    do { \
+        ostringstream checkText; \
+        if (!((expected) == (actual))) { \
+            checkText << #actual << " is " << (actual) << ", expected " << (expected); \
+            reportFailure(__FILE__, __LINE__, checkText.str()); \
+        } \
+    } while (0)
+
+// Stop the test if the condition fails (later checks depend on it)
+#define REQUIRE(condition) \
+    do { \
+        if (!(condition)) { \
+            reportFailure(__FILE__, __LINE__, "REQUIRE(" #condition ")"); \
+            return; \
+        } \
+    } while (0)
+
+// Student with the given ID and course count, scores and average filled in
+// from the ID so every student is different and reproducible
+Student makeTestStudent(unsigned long long packedId, int courseCount);
+
+// Same fields, same scores and same average
+bool sameStudent(const Student& a, const Student& b);
+
+// Send cin/cout to strings while the object exists (for menu prompts)
+class ConsoleCapture {
+private:
+    istringstream input;
+    ostringstream output;
+    streambuf* oldIn;
+    streambuf* oldOut;
+
+    // Not copyable
+    ConsoleCapture(const ConsoleCapture& other);
+    ConsoleCapture& operator=(const ConsoleCapture& other);
+
+public:
+    ConsoleCapture(const string& text);
+    ~ConsoleCapture();
+    string getOutput() const;
+};
+
+#endif // TESTHARNESS_H
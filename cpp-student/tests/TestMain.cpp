@@ -0,0 +1,118 @@
+// TestMain.cpp - Runs the registered component tests
+#include "TestHarness.h"
+#include "../ChangeFeed.h"
+#include "../AuditLog.h"
+
+// Registered tests (filled by static initializers, so a function-local
+// array avoids initialization order problems)
+const int MAX_TESTS = 256;
+
+struct TestEntry {
+    const char* name;
+    TestFunction function;
+};
+
+static TestEntry* testTable(int*& count) {
+    static TestEntry tests[MAX_TESTS];
+    static int testCount = 0;
+    count = &testCount;
+    return tests;
+}
+
+static int failedChecks = 0;
+
+// Add a test to the registry
+bool registerTest(const char* name, TestFunction function) {
+    int* count;
+    TestEntry* tests = testTable(count);
+    if (*count < MAX_TESTS) {
+        tests[*count].name = name;
+        tests[*count].function = function;
+        (*count)++;
+    }
+    return true;
+}
+
+// Record a failed check of the running test
+void reportFailure(const char* file, int line, const string& message) {
+    cerr << "  " << file << ":" << line << ": " << message << endl;
+    failedChecks++;
+}
+
+// Student with fields derived from the ID
+Student makeTestStudent(unsigned long long packedId, int courseCount) {
+    // Test students are not roster changes
+    ChangeFeedMute mute;
+    AuditMute auditMute;
+    ostringstream name;
+    name << "S" << (packedId % 10000000);
+    Student s(unpackStudentId(packedId), name.str(), 17 + (int)(packedId % 20),
+              packedId % 2 == 0 ? 'M' : 'F', courseCount);
+    for (int i = 0; i < courseCount; i++) {
+        // Quarter points, exact in binary and in hundredths
+        s.setScore(i, (double)((packedId * 7 + i * 13) % 401) / 4);
+    }
+    s.calcAverage();
+    return s;
+}
+
+// Same fields, same scores and same average
+bool sameStudent(const Student& a, const Student& b) {
+    if (a.getStudentId() != b.getStudentId() || a.getName() != b.getName()
+        || a.getAge() != b.getAge() || a.getGender() != b.getGender()
+        || a.getCourseCount() != b.getCourseCount() || a.getAvgScore() != b.getAvgScore()) {
+        return false;
+    }
+    for (int i = 0; i < a.getCourseCount(); i++) {
+        if (a.getScore(i) != b.getScore(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Send cin/cout to strings
+ConsoleCapture::ConsoleCapture(const string& text) : input(text) {
+    oldIn = cin.rdbuf(input.rdbuf());
+    oldOut = cout.rdbuf(output.rdbuf());
+}
+
+ConsoleCapture::~ConsoleCapture() {
+    cin.rdbuf(oldIn);
+    cout.rdbuf(oldOut);
+    cin.clear();
+}
+
+string ConsoleCapture::getOutput() const {
+    return output.str();
+}
+
+// Run every test, or only the tests named on the command line
+int main(int argc, char* argv[]) {
+    int* count;
+    TestEntry* tests = testTable(count);
+    int run = 0;
+    int failedTests = 0;
+    for (int t = 0; t < *count; t++) {
+        bool selected = argc < 2;
+        for (int a = 1; a < argc; a++) {
+            if (string(argv[a]) == tests[t].name) {
+                selected = true;
+            }
+        }
+        if (!selected) {
+            continue;
+        }
+        int before = failedChecks;
+        tests[t].function();
+        run++;
+        if (failedChecks != before) {
+            cout << "[ FAIL ] " << tests[t].name << endl;
+            failedTests++;
+        } else {
+            cout << "[  OK  ] " << tests[t].name << endl;
+        }
+    }
+    cout << run << " tests, " << failedTests << " failed" << endl;
+    return failedTests == 0 && run > 0 ? 0 : 1;
+}
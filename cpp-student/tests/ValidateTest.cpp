@@ -0,0 +1,63 @@
+// ValidateTest.cpp - Batch validators against the single-value checks
+#include "TestHarness.h"
+#include "../Validate.h"
+#include <cmath>
+
+TEST(parseId10AcceptsOnlyTenDigits) {
+    unsigned long long packed = 0;
+    CHECK(parseId10("2024000001", packed));
+    CHECK_EQUAL(2024000001ULL, packed);
+    CHECK(parseId10("0000000000", packed));
+    CHECK_EQUAL(0ULL, packed);
+    CHECK(parseId10("9999999999", packed));
+    CHECK_EQUAL(9999999999ULL, packed);
+    const char* bad[] = { "202400000a", "/024000001", "2024:00001", "2024 00001", "202400000\x7f" };
+    for (int i = 0; i < 5; i++) {
+        CHECK(!parseId10(bad[i], packed));
+    }
+}
+
+TEST(idColumnMarksBadRows) {
+    const int rows = 130;
+    string ids[rows];
+    for (int i = 0; i < rows; i++) {
+        ids[i] = unpackStudentId(2024000000ULL + i);
+    }
+    ids[3] = "123";
+    ids[64] = "20240000x1";
+    ids[129] = "20240000011";
+    unsigned long long packed[rows];
+    unsigned long long errors[3];
+    clearErrorBitmap(errors, rows);
+    CHECK_EQUAL(3, validateIdColumn(ids, rows, packed, errors));
+    for (int i = 0; i < rows; i++) {
+        bool bad = i == 3 || i == 64 || i == 129;
+        CHECK_EQUAL(bad, rowHasError(errors, i));
+        CHECK_EQUAL(bad ? 0ULL : 2024000000ULL + i, packed[i]);
+    }
+}
+
+TEST(scoreAndNameColumnsShareBitmap) {
+    const int rows = 70;
+    double scores[rows];
+    string names[rows];
+    for (int i = 0; i < rows; i++) {
+        scores[i] = i;
+        names[i] = "Name";
+    }
+    scores[5] = -0.01;
+    scores[6] = 100.01;
+    scores[7] = NAN;
+    scores[8] = 100;
+    scores[9] = 0;
+    names[10] = "";
+    names[69] = "NineChars";
+    unsigned long long errors[2];
+    clearErrorBitmap(errors, rows);
+    CHECK_EQUAL(3, validateScoreColumn(scores, rows, errors));
+    CHECK_EQUAL(2, validateNameColumn(names, rows, errors));
+    for (int i = 0; i < rows; i++) {
+        bool bad = (i >= 5 && i <= 7) || i == 10 || i == 69;
+        CHECK_EQUAL(bad, rowHasError(errors, i));
+    }
+}
@@ -0,0 +1,11 @@
+#!/bin/sh
+# run_tests.sh - Build the component tests with every source except
+# main.cpp and run them in a scratch directory
+set -e
+cd "$(dirname "$0")"
+SOURCES=$(ls ../*.cpp | grep -v '/main.cpp$')
+BUILD=$(mktemp -d)
+trap 'rm -rf "$BUILD"' EXIT
+g++ -O2 -std=c++17 -pthread -Wall -Wextra -o "$BUILD/student_tests" ./*.cpp $SOURCES
+cd "$BUILD"
+./student_tests "$@"